@@ -0,0 +1,43 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <stddef.h>
+
+/* Size classes served from the per-thread pool: 1 KiB, 4 KiB, 16 KiB, 64 KiB, 256 KiB. */
+#define BUFFER_POOL_NUM_CLASSES 5
+#define BUFFER_POOL_MIN_SIZE 1024
+#define BUFFER_POOL_MAX_SIZE (BUFFER_POOL_MIN_SIZE << (2 * (BUFFER_POOL_NUM_CLASSES - 1)))
+
+/* Upper bound on the bytes a single thread keeps cached across requests. */
+#define BUFFER_POOL_HIGH_WATER (1024 * 1024)
+
+char *buffer_pool_acquire(size_t min_size, size_t *out_capacity);
+
+char *buffer_pool_grow(char *buf, size_t used, size_t min_size, size_t *out_capacity);
+
+void buffer_pool_release(char *buf);
+
+void buffer_pool_thread_cleanup(void);
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,74 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "job_pool.h"
+
+/*
+ * Response compression: Accept-Encoding negotiation, one-shot gzip and deflate through
+ * zlib, and a small job pool (see job_pool.h) that compresses large bodies off the event
+ * loop.
+ */
+typedef enum {
+    HTTP_ENCODING_IDENTITY,
+    HTTP_ENCODING_GZIP,
+    HTTP_ENCODING_DEFLATE,
+    HTTP_ENCODING_COUNT,
+} HttpEncoding;
+
+typedef struct CompressJob {
+    PoolJob job;  // first, so a finished PoolJob leads back here
+    HttpEncoding encoding;
+    // the input, or, with input NULL, input_len bytes read from input_fd at input_off
+    const char *input;
+    size_t input_len;
+    int input_fd;
+    off_t input_off;
+    char *output;  // NULL if compressing failed or did not make the body smaller
+    size_t output_len;
+} CompressJob;
+
+HttpEncoding http_negotiate_encoding(const char *accept_encoding);
+
+const char *http_encoding_name(HttpEncoding encoding);
+
+int http_compressible_type(const char *content_type);
+
+void http_compress_set_level(int level);
+
+int http_compress(HttpEncoding encoding, const char *input, size_t input_len, char **output, size_t *output_len);
+
+void http_compress_thread_cleanup(void);
+
+int compress_pool_start(int threads);
+
+void compress_pool_stop(void);
+
+int compress_submit(CompressJob *job, JobCompletions *done);
+
+void compress_run(CompressJob *job);
+
+#endif // COMPRESS_H
@@ -0,0 +1,59 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FAIR_QUEUE_H
+#define FAIR_QUEUE_H
+
+#include <stddef.h>
+
+/* Longest flow key that is kept; longer keys are truncated. */
+#define FAIR_QUEUE_KEY_SIZE 64
+
+/*
+ * Deficit round robin across flows. Each flow gets `quantum` units of credit per
+ * round and an item is served once its cost fits the flow's credit. Within one
+ * flow, items leave in `order` (smallest first), FIFO among equal orders.
+ */
+typedef struct FairQueue FairQueue;
+
+typedef struct FairQueueItem {
+    long long order;
+    size_t cost;
+    int fd;
+    int flags;
+    void *data;
+} FairQueueItem;
+
+FairQueue *fair_queue_create(size_t quantum);
+
+void fair_queue_destroy(FairQueue *fq);
+
+int fair_queue_push(FairQueue *fq, const char *flow, const FairQueueItem *item);
+
+int fair_queue_pop(FairQueue *fq, FairQueueItem *out);
+
+size_t fair_queue_size(const FairQueue *fq);
+
+size_t fair_queue_flow_size(const FairQueue *fq, const char *flow);
+
+void fair_queue_peer_key(int fd, char *key, size_t key_size);
+
+#endif // FAIR_QUEUE_H
@@ -0,0 +1,76 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FS_POOL_H
+#define FS_POOL_H
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+#include "job_pool.h"
+#include "v8_api_access.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Backing for ASP.fs: a small job pool (see job_pool.h) that runs blocking file calls
+ * off the event loop. The reactor that submitted a call settles its Promise once the
+ * job comes back.
+ */
+typedef enum {
+    FS_READ_FILE,
+    FS_WRITE_FILE,
+    FS_STAT,
+} FsOp;
+
+typedef struct FsJob {
+    PoolJob job;  // first, so a finished PoolJob leads back here
+    FsOp op;
+    char *path;
+    // the bytes to write, or the contents read
+    char *data;
+    size_t len;
+    struct stat st;
+    int error;          // errno of the failed call, 0 on success
+    JSObject resolver;  // the Promise to settle, owned by the isolate that made the call
+} FsJob;
+
+FsJob *fs_job_create(FsOp op, const char *path, const char *data, size_t len);
+
+void fs_job_free(FsJob *job);
+
+const char *fs_op_name(FsOp op);
+
+void fs_run(FsJob *job);
+
+int fs_pool_start(int threads);
+
+void fs_pool_stop(void);
+
+int fs_submit(FsJob *job, JobCompletions *done);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FS_POOL_H
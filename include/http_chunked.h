@@ -0,0 +1,71 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef HTTP_CHUNKED_H
+#define HTTP_CHUNKED_H
+
+#include <stddef.h>
+
+/*
+ * Request body framing, shared by the servers. A body is either Content-Length bytes
+ * long or sent with Transfer-Encoding: chunked. A chunked body is decoded
+ * incrementally in the connection's input buffer: each call decodes what has arrived
+ * since the last one and moves the chunk data down over the framing, so the body ends
+ * up contiguous right behind the headers without a second buffer.
+ */
+typedef enum {
+    HTTP_BODY_LENGTH,   // Content-Length bytes, none without the header
+    HTTP_BODY_CHUNKED,
+    HTTP_BODY_INVALID,  // a non-numeric Content-Length, a transfer coding other than chunked last,
+                        // or one next to a Content-Length
+} HttpBodyFraming;
+
+typedef enum {
+    HTTP_CHUNK_SIZE,      // reading a chunk-size line
+    HTTP_CHUNK_DATA,      // reading chunk data
+    HTTP_CHUNK_DATA_END,  // reading the CRLF after the data
+    HTTP_CHUNK_TRAILER,   // reading trailer lines after the last chunk
+} HttpChunkState;
+
+typedef enum {
+    HTTP_CHUNKED_MORE,       // the body continues in bytes not read yet
+    HTTP_CHUNKED_DONE,       // the body is complete, the request ends at out
+    HTTP_CHUNKED_INVALID,    // malformed framing
+    HTTP_CHUNKED_TOO_LARGE,  // the body would exceed max_body
+} HttpChunkedStatus;
+
+typedef struct HttpChunkedDecoder {
+    HttpChunkState state;
+    size_t start;     // offset of the body in the buffer
+    size_t in;        // first byte not decoded yet
+    size_t out;       // end of the decoded body
+    size_t left;      // data bytes of the current chunk still to come
+    size_t trailer;   // trailer bytes seen so far
+    size_t max_body;
+} HttpChunkedDecoder;
+
+HttpBodyFraming http_body_framing(const char *headers, size_t header_len, size_t *content_length);
+
+void http_chunked_init(HttpChunkedDecoder *decoder, size_t body_start, size_t max_body);
+
+HttpChunkedStatus http_chunked_decode(HttpChunkedDecoder *decoder, char *buf, size_t *len);
+
+#endif // HTTP_CHUNKED_H
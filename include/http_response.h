@@ -0,0 +1,60 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+// "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+#define HTTP_DATE_HEADER_LEN 37
+// status line, Date, header block and body
+#define HTTP_RESPONSE_IOV 4
+
+/*
+ * Scatter-gather response serialization, shared by the servers. A response is written
+ * with one writev of four pieces: the status line, the Date line, the header block and
+ * the body. Status lines are made once per code, and each thread keeps its Date line and
+ * reformats it only when the second changes. So per response only the headers that
+ * depend on it are formatted, and the body is sent from where it already is.
+ */
+typedef struct HttpResponse {
+    int status;
+    char *headers;  // the lines after Date, through the blank line that ends the head
+    size_t headers_len;
+    char *body;  // sent after the head unless NULL
+    size_t body_len;
+} HttpResponse;
+
+const char *http_status_line(int status, size_t *len);
+
+void http_date_refresh(void);
+
+const char *http_date_header(void);
+
+int http_response_iov(const HttpResponse *response, struct iovec iov[HTTP_RESPONSE_IOV]);
+
+size_t http_response_length(const HttpResponse *response);
+
+void http_response_free(HttpResponse *response);
+
+#endif // HTTP_RESPONSE_H
@@ -0,0 +1,43 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef ISOLATE_POOL_H
+#define ISOLATE_POOL_H
+
+#include "job_pool.h"
+#include "v8_api_access.h"
+
+/*
+ * A job pool (see job_pool.h) whose threads each own a V8 isolate loaded with the app
+ * script, so JS handlers can run off the event loop. A job runs on whichever worker
+ * takes it first, and its run callback gets that worker's V8Engine.
+ */
+int isolate_pool_start(V8Engine *parent, int threads, int first_slot);
+
+void isolate_pool_stop(void);
+
+int isolate_pool_size(void);
+
+int isolate_pool_on_worker(void);
+
+int isolate_pool_submit(PoolJob *job);
+
+#endif // ISOLATE_POOL_H
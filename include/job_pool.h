@@ -0,0 +1,78 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <pthread.h>
+
+/*
+ * A pool of threads that runs jobs off the event loop, shared by the compression, handler
+ * and fs pools. Jobs run in the order they were queued, on whichever thread takes them
+ * first. A finished job goes onto the completion list it names, which belongs to the
+ * reactor that submitted it, and the list's eventfd wakes that reactor up to pick it up.
+ *
+ * A job type embeds PoolJob as its first member, so a finished PoolJob leads back to it.
+ */
+typedef struct JobCompletions {
+    pthread_mutex_t lock;
+    struct PoolJob *head;
+    int event_fd;
+} JobCompletions;
+
+typedef struct PoolJob {
+    // worker is what thread_start returned on the thread that runs the job
+    void (*run)(struct PoolJob *job, void *worker);
+    JobCompletions *done;
+    struct PoolJob *next;
+} PoolJob;
+
+typedef struct JobPool {
+    // optional per-thread setup; a thread whose start returns NULL takes no jobs
+    void *(*thread_start)(int index);
+    void (*thread_stop)(void *worker);
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_cond_t ready_cond;
+    PoolJob *head, *tail;
+    pthread_t *threads;
+    int started;   // threads created
+    int entered;   // threads that have taken an index
+    int reported;  // threads that have set up or given up
+    int size;      // threads taking jobs
+    int stopping;
+} JobPool;
+
+int job_pool_start(JobPool *pool, int threads);
+
+void job_pool_stop(JobPool *pool);
+
+int job_pool_size(JobPool *pool);
+
+int job_pool_submit(JobPool *pool, PoolJob *job);
+
+int job_completions_init(JobCompletions *done);
+
+void job_completions_destroy(JobCompletions *done);
+
+PoolJob *job_completions_take(JobCompletions *done);
+
+#endif // JOB_POOL_H
@@ -51,6 +51,7 @@ typedef struct {
     int header_count;
 } EvHttpRequest;
 
-void register_js_interval_callback(int ms, JSObject cb);
+long long register_js_timer(int ms, int repeat, JSObject cb);
+void clear_js_timer(long long id);
 
 #endif // EVENT_BASED_SERVER_H
@@ -0,0 +1,111 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "compress.h"
+
+#define RESPONSE_CACHE_SHARDS 16
+#define RESPONSE_CACHE_VARY_MAX 8
+
+/*
+ * Process-wide cache of handler responses, shared by every reactor. A handler opts in by
+ * returning a Cache-Control header with max-age; stale-while-revalidate=N lets a stale
+ * entry be served for N more seconds while one request refreshes it through JS. Entries
+ * are keyed by method and path, plus the values of the request headers the response
+ * names in Vary.
+ *
+ * The cache is split into shards by path, each with its own lock, byte budget and LRU
+ * list. A lookup hands out a counted reference, so an entry evicted or invalidated by
+ * another reactor stays valid until the response built from it has been copied out.
+ *
+ * Compressed variants of an entry's body are made on first demand and kept with it, so a
+ * body is compressed once per coding however often it is served.
+ */
+typedef struct ResponseCacheEncoded {
+    size_t len;  // 0 if the coding did not make the body smaller
+    char data[];
+} ResponseCacheEncoded;
+
+typedef struct ResponseCacheEntry {
+    unsigned hash;
+    char *method;
+    char *path;
+    int vary_count;
+    char *vary_names[RESPONSE_CACHE_VARY_MAX];
+    char *vary_values[RESPONSE_CACHE_VARY_MAX];  // NULL if the request had no such header
+    int status;
+    char *content_type;
+    char *cache_control;
+    char *vary;  // as the handler sent it, NULL if it sent none
+    char *etag;  // NULL if the response has none
+    char *body;
+    size_t body_len;
+    size_t cost;
+    long long stored_ms;
+    long long fresh_until_ms;
+    long long stale_until_ms;
+    long long revalidating_ms;  // when a request set out to refresh it, 0 if none has
+    int cached;
+    // set once and never changed, so holders of a reference may read them without the lock
+    _Atomic(ResponseCacheEncoded *) encoded[HTTP_ENCODING_COUNT];
+    atomic_int encoding_claims;  // codings some thread is already compressing
+    atomic_int refs;
+    struct ResponseCacheEntry *hash_next;
+    struct ResponseCacheEntry *lru_prev, *lru_next;
+} ResponseCacheEntry;
+
+typedef enum {
+    RESPONSE_CACHE_MISS,
+    RESPONSE_CACHE_FRESH,
+    RESPONSE_CACHE_STALE,       // serve it, another request is already refreshing it
+    RESPONSE_CACHE_REVALIDATE,  // serve it, then run the handler and store the result
+} ResponseCacheResult;
+
+// returns the value of a request header, or NULL
+typedef const char *(*ResponseCacheHeaderFn)(const void *request, const char *name);
+
+void response_cache_init(size_t budget_bytes);
+
+int response_cache_enabled(void);
+
+ResponseCacheResult response_cache_lookup(const char *method, const char *path, ResponseCacheHeaderFn header,
+                                          const void *request, long long now_ms, int may_revalidate,
+                                          ResponseCacheEntry **out);
+
+ResponseCacheEntry *response_cache_store(const char *method, const char *path, ResponseCacheHeaderFn header,
+                                         const void *request, long long now_ms, int status, const char *content_type,
+                                         const char *body, size_t body_len, const char *cache_control, const char *vary,
+                                         const char *etag);
+
+void response_cache_release(ResponseCacheEntry *entry);
+
+int response_cache_claim_encoding(ResponseCacheEntry *entry, HttpEncoding encoding);
+
+void response_cache_attach_encoded(ResponseCacheEntry *entry, HttpEncoding encoding, const char *data, size_t len);
+
+int response_cache_invalidate(const char *path);
+
+#endif // RESPONSE_CACHE_H
@@ -0,0 +1,55 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SOCKET_TUNING_H
+#define SOCKET_TUNING_H
+
+#include <stddef.h>
+
+/*
+ * Socket options applied to every listening and accepted TCP socket of the servers, read
+ * once from the ASP_SOCK_* settings. Options that accepted sockets inherit, such as the
+ * buffer sizes and SO_BUSY_POLL, are set on the listener before listen(); only what does
+ * not carry over is set per connection. The values the kernel actually applied are read
+ * back from the first listener and reported in telemetry.
+ */
+typedef struct SocketTuning {
+    int backlog;       // listen() backlog
+    int nodelay;       // TCP_NODELAY, on or off
+    int defer_accept;  // TCP_DEFER_ACCEPT seconds, 0 off, -1 the server's own default
+    int fastopen;      // TCP_FASTOPEN queue length, 0 off
+    int busy_poll;     // SO_BUSY_POLL microseconds, 0 off
+    int quickack;      // TCP_QUICKACK on accepted sockets, on or off
+    int sndbuf;        // SO_SNDBUF bytes, 0 leaves the kernel's autotuning
+    int rcvbuf;        // SO_RCVBUF bytes, 0 leaves the kernel's autotuning
+} SocketTuning;
+
+void socket_tuning_init(void);
+
+int socket_tuning_backlog(void);
+
+void socket_tune_listener(int fd, int defer_accept_default);
+
+void socket_tune_accepted(int fd);
+
+int socket_tuning_describe(char *buf, size_t size);
+
+#endif // SOCKET_TUNING_H
@@ -0,0 +1,83 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef STATIC_FILES_H
+#define STATIC_FILES_H
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include "compress.h"
+
+#define STATIC_MAX_ROUTES 16
+#define STATIC_PATH_MAX 4096
+// larger files are always sent as they are, with sendfile
+#define STATIC_COMPRESS_MAX (1024 * 1024)
+
+/*
+ * Static file serving for ASP.serveStatic(prefix, dir). The route table is process-wide
+ * and only grows; every isolate replays the app script, so registering a prefix again
+ * is a no-op. Lookups take no lock.
+ *
+ * Each reactor keeps its own cache of open files with their stat results, so a hot file
+ * is served with no open or stat at all. An entry is re-validated with stat() at most
+ * once a second and reopened if the file was replaced. Queued responses hold a reference,
+ * so an entry dropped from the cache keeps its fd until the last send is done.
+ *
+ * A compressible file also keeps its gzip and deflate variants in memory once one has been
+ * asked for; they go with the entry when the file changes.
+ */
+typedef struct StaticFile {
+    int fd;
+    off_t size;
+    time_t mtime;
+    const char *content_type;
+    char *path;
+    dev_t dev;
+    ino_t ino;
+    long long checked_ms;  // last stat()
+    char *encoded[HTTP_ENCODING_COUNT];
+    size_t encoded_len[HTTP_ENCODING_COUNT];
+    unsigned encodings_tried;  // made, being made, or not worth it
+    int refs;
+    int cached;
+    struct StaticFile *hash_next;
+    struct StaticFile *lru_prev, *lru_next;
+} StaticFile;
+
+typedef struct StaticFileCache StaticFileCache;
+
+int static_files_add_route(const char *prefix, const char *dir);
+
+int static_files_resolve(const char *url_path, char *out, size_t out_size);
+
+StaticFileCache *static_file_cache_create(int capacity);
+
+void static_file_cache_destroy(StaticFileCache *cache);
+
+StaticFile *static_file_open(StaticFileCache *cache, const char *path, long long now_ms);
+
+void static_file_release(StaticFile *file);
+
+int static_file_parse_range(const char *header, off_t size, off_t *start, off_t *length);
+
+#endif // STATIC_FILES_H
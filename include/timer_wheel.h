@@ -0,0 +1,75 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+/*
+ * Hierarchical timing wheel with millisecond ticks. Level 0 has one slot per tick for
+ * the next 256 ms, and each level above covers 256 times the span of the one below, so
+ * four levels reach about 49 days. Timers further out are clamped to that. Inserting and
+ * cancelling are O(1). Advancing cascades a higher-level slot down only when its span
+ * begins, and it skips straight over empty stretches using per-level occupancy bitmaps.
+ * Not thread-safe; a wheel belongs to one thread.
+ */
+typedef struct TimerEntry TimerEntry;
+
+typedef void (*TimerCallback)(TimerEntry *timer, void *arg);
+
+struct TimerEntry {
+    TimerEntry *next;
+    TimerEntry *prev;  // NULL while the timer is not scheduled
+    uint64_t expires;  // absolute tick, in milliseconds
+    TimerCallback callback;
+    void *arg;
+    unsigned short level;
+    unsigned short slot;
+};
+
+typedef struct TimerWheel {
+    uint64_t now;  // last tick processed
+    size_t count;
+    TimerEntry slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now);
+
+void timer_entry_init(TimerEntry *timer, TimerCallback callback, void *arg);
+
+void timer_wheel_add(TimerWheel *wheel, TimerEntry *timer, uint64_t expires);
+
+void timer_wheel_cancel(TimerWheel *wheel, TimerEntry *timer);
+
+int timer_entry_pending(const TimerEntry *timer);
+
+size_t timer_wheel_advance(TimerWheel *wheel, uint64_t now);
+
+uint64_t timer_wheel_next_deadline(const TimerWheel *wheel);
+
+#endif // TIMER_WHEEL_H
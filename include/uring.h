@@ -0,0 +1,85 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+/*
+ * A minimal io_uring binding over the raw syscalls, just what the event loop needs:
+ * a submission and a completion ring, and provided-buffer rings for multishot recv.
+ * One ring belongs to one thread; nothing here is thread-safe.
+ */
+typedef struct Uring {
+    int fd;
+    unsigned features;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_pending;  // SQEs filled but not yet handed to the kernel
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+} Uring;
+
+/* Buffers the kernel picks from for recv with IOSQE_BUFFER_SELECT. */
+typedef struct UringBufRing {
+    struct io_uring_buf_ring *ring;
+    size_t ring_size;
+    char *bufs;
+    size_t buf_size;
+    unsigned entries;
+    unsigned short tail;
+    unsigned short group;
+} UringBufRing;
+
+int uring_init(Uring *ring, unsigned entries);
+
+void uring_exit(Uring *ring);
+
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+
+int uring_submit_and_wait(Uring *ring, unsigned wait_nr, int timeout_ms);
+
+struct io_uring_cqe *uring_peek_cqe(Uring *ring);
+
+void uring_cqe_seen(Uring *ring);
+
+int uring_buf_ring_init(Uring *ring, UringBufRing *br, unsigned entries, size_t buf_size, unsigned short group);
+
+void uring_buf_ring_free(Uring *ring, UringBufRing *br);
+
+char *uring_buf_ring_buffer(const UringBufRing *br, unsigned short bid);
+
+void uring_buf_ring_recycle(UringBufRing *br, unsigned short bid);
+
+#endif // URING_H
@@ -25,6 +25,7 @@
 #include <signal.h>
 
 #include "v8_api_access.h"
+#include <stddef.h>
 #include <time.h>
 
 extern int server_fd_global;
@@ -44,8 +45,53 @@ void telemetry_increment_200_responses();
 
 int telemetry_get_200_responses();
 
+void telemetry_increment_read_timeouts();
+
+int telemetry_get_read_timeouts();
+
+void telemetry_increment_deadline_drops();
+
+int telemetry_get_deadline_drops();
+
+void telemetry_increment_fair_rejects();
+
+int telemetry_get_fair_rejects();
+
+void telemetry_increment_idle_timeouts();
+
+int telemetry_get_idle_timeouts();
+
+void telemetry_increment_evictions();
+
+int telemetry_get_evictions();
+
+void telemetry_increment_cache_hits();
+
+int telemetry_get_cache_hits();
+
+void telemetry_increment_cache_misses();
+
+int telemetry_get_cache_misses();
+
 void telemetry_get_start_time(struct timespec *out);
 
+const char *http_status_text(int status);
+
+void format_http_date(char *buf, size_t len);
+
+long long monotonic_ms(void);
+
+// a quoted 16-digit hex ETag and its terminator
+#define HTTP_ETAG_SIZE 19
+
+void http_etag(const char *body, size_t len, char *out, size_t out_size);
+
+int http_etag_matches(const char *if_none_match, size_t header_len, const char *etag);
+
+const char *config_get_string(const char *name, const char *default_value);
+
+int config_get_int(const char *name, int default_value);
+
 void start_server(V8Engine *engine);
 
 #endif //SERVER_UTILS_H
@@ -77,6 +77,10 @@ extern "C" {
 
     V8Engine *v8_initialize(int argc, char *argv[]);
 
+    V8Engine *v8_create_isolate(V8Engine *parent);
+
+    void v8_dispose_isolate(V8Engine *engine);
+
     JSResult v8_execute_script(V8Engine *engine, const char *script);
 
     int v8_register_function(V8Engine *engine, const char *name, int (*func)(int));
@@ -93,6 +97,10 @@ extern "C" {
 
     HTTPServerType v8_get_server_type(V8Engine *engine);
 
+    struct FsJob;
+
+    void v8_settle_fs_job(V8Engine *engine, struct FsJob *job);
+
 #ifdef __cplusplus
 }
 
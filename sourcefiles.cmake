@@ -4,7 +4,35 @@ set(SOURCE_FILES
         src/m3__multi_threaded_server.c
         src/m4_5__event_based_server.c
         src/utils.c
+        src/buffer_pool.c
+        src/affinity.c
+        src/fair_queue.c
+        src/uring.c
+        src/timer_wheel.c
+        src/static_files.c
+        src/response_cache.c
+        src/compress.c
+        src/http_response.c
+        src/http_chunked.c
+        src/socket_tuning.c
+        src/job_pool.c
+        src/isolate_pool.c
+        src/fs_pool.c
         include/utils.h
+        include/buffer_pool.h
+        include/affinity.h
+        include/fair_queue.h
+        include/uring.h
+        include/timer_wheel.h
+        include/static_files.h
+        include/response_cache.h
+        include/compress.h
+        include/http_response.h
+        include/http_chunked.h
+        include/socket_tuning.h
+        include/job_pool.h
+        include/isolate_pool.h
+        include/fs_pool.h
         include/m3__multi_threaded_server.h
         include/m4_5__event_based_server.h
 )
\ No newline at end of file
@@ -0,0 +1,327 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#define _GNU_SOURCE
+
+#include "affinity.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "utils.h"
+
+#define AFFINITY_MAX_NODES 64
+
+typedef struct {
+    int cpu;
+    int node;
+    int package;
+    int core;
+    int sibling_rank;
+    int node_rank;
+} CpuInfo;
+
+/*
+ * Placement plan built once at startup. `cpus` holds the usable CPUs in the order
+ * in which slots are handed out; slot i runs on cpus[i % num_cpus].
+ */
+static AffinityPolicy policy = AffinityPolicyNone;
+static CpuInfo cpus[CPU_SETSIZE];
+static int num_cpus = 0;
+static int node_ids[AFFINITY_MAX_NODES];
+static int num_nodes = 0;
+
+static const char *policy_names[] = { "none", "compact", "scatter", "list", "numa" };
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Topology helpers reading /sys/devices/system              *
+  *************************************************************
+*/
+static int read_sysfs_int(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    int value = -1;
+    if (fscanf(f, "%d", &value) != 1) value = -1;
+    fclose(f);
+    return value;
+}
+
+static int node_of_cpu(int cpu) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (!dir) return 0;
+    int node = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Parses a kernel-style cpu list such as "0,2,4-7" into an  *
+  * ordered array. Returns the number of entries or -1.       *
+  *************************************************************
+*/
+static int parse_cpu_list(const char *list, int *out, int max) {
+    int count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPU_SETSIZE) return -1;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first || last >= CPU_SETSIZE) return -1;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && count < max; cpu++) {
+            out[count++] = (int)cpu;
+        }
+        if (*p == ',') p++;
+        else if (*p) return -1;
+    }
+    return count;
+}
+
+static int compare_compact(const void *a, const void *b) {
+    const CpuInfo *x = a, *y = b;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core != y->core) return x->core - y->core;
+    return x->cpu - y->cpu;
+}
+
+static int compare_spread_in_node(const void *a, const void *b) {
+    const CpuInfo *x = a, *y = b;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->sibling_rank != y->sibling_rank) return x->sibling_rank - y->sibling_rank;
+    return compare_compact(a, b);
+}
+
+static int compare_scatter(const void *a, const void *b) {
+    const CpuInfo *x = a, *y = b;
+    if (x->node_rank != y->node_rank) return x->node_rank - y->node_rank;
+    return x->node - y->node;
+}
+
+static void remember_node(int node) {
+    for (int i = 0; i < num_nodes; i++) {
+        if (node_ids[i] == node) return;
+    }
+    if (num_nodes < AFFINITY_MAX_NODES) node_ids[num_nodes++] = node;
+}
+
+static void describe_cpu(CpuInfo *info, int cpu) {
+    char path[128];
+    info->cpu = cpu;
+    info->node = node_of_cpu(cpu);
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    info->package = read_sysfs_int(path);
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+    info->core = read_sysfs_int(path);
+    if (info->core < 0) info->core = cpu;
+    info->sibling_rank = 0;
+    info->node_rank = 0;
+    remember_node(info->node);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Builds the placement plan from ASP_AFFINITY:              *
+  *   compact     fill sibling threads and cores of one node  *
+  *   scatter     round-robin nodes, one thread per core      *
+  *   list:0,2-5  explicit cpu order                          *
+  *   numa        one node per slot, memory kept node-local   *
+  *************************************************************
+*/
+void affinity_init(void) {
+    const char *spec = config_get_string("ASP_AFFINITY", "none");
+    if (strcmp(spec, "none") == 0) return;
+    if (strcmp(spec, "compact") == 0) {
+        policy = AffinityPolicyCompact;
+    } else if (strcmp(spec, "scatter") == 0) {
+        policy = AffinityPolicyScatter;
+    } else if (strcmp(spec, "numa") == 0) {
+        policy = AffinityPolicyNuma;
+    } else if (strncmp(spec, "list:", 5) == 0) {
+        policy = AffinityPolicyList;
+    } else {
+        fprintf(stderr, "Unknown ASP_AFFINITY policy '%s', threads stay unpinned\n", spec);
+        return;
+    }
+
+    if (policy == AffinityPolicyList) {
+        static int order[CPU_SETSIZE];
+        int count = parse_cpu_list(spec + 5, order, CPU_SETSIZE);
+        if (count <= 0) {
+            fprintf(stderr, "Invalid cpu list in ASP_AFFINITY '%s', threads stay unpinned\n", spec);
+            policy = AffinityPolicyNone;
+            return;
+        }
+        for (int i = 0; i < count; i++) describe_cpu(&cpus[i], order[i]);
+        num_cpus = count;
+    } else {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            perror("sched_getaffinity");
+            policy = AffinityPolicyNone;
+            return;
+        }
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) describe_cpu(&cpus[num_cpus++], cpu);
+        }
+        for (int i = 0; i < num_cpus; i++) {
+            for (int j = 0; j < i; j++) {
+                if (cpus[j].package == cpus[i].package && cpus[j].core == cpus[i].core) cpus[i].sibling_rank++;
+            }
+        }
+        if (policy == AffinityPolicyScatter) {
+            qsort(cpus, num_cpus, sizeof(CpuInfo), compare_spread_in_node);
+            for (int i = 1; i < num_cpus; i++) {
+                if (cpus[i].node == cpus[i - 1].node) cpus[i].node_rank = cpus[i - 1].node_rank + 1;
+            }
+            qsort(cpus, num_cpus, sizeof(CpuInfo), compare_scatter);
+        } else {
+            qsort(cpus, num_cpus, sizeof(CpuInfo), compare_compact);
+        }
+    }
+
+    printf("CPU affinity: %s over %d cpu(s) on %d NUMA node(s), order:", policy_names[policy], num_cpus, num_nodes);
+    if (policy == AffinityPolicyNuma) {
+        for (int i = 0; i < num_nodes; i++) printf(" node%d", node_ids[i]);
+    } else {
+        for (int i = 0; i < num_cpus; i++) printf(" %d", cpus[i].cpu);
+    }
+    printf("\n");
+}
+
+AffinityPolicy affinity_get_policy(void) {
+    return policy;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Prefers the given node for future page allocations of     *
+  * the calling thread, so buffers it first touches (and the  *
+  * isolate heap when bound before V8 starts) stay local.     *
+  *************************************************************
+*/
+static void prefer_local_memory(int node) {
+    if (num_nodes < 2 || node < 0 || node >= (int)(8 * sizeof(unsigned long))) return;
+    unsigned long mask = 1UL << node;
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, 8 * sizeof(mask)) != 0) {
+        perror("set_mempolicy");
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Pins the calling thread to the cpu (or, for the numa      *
+  * policy, the node) that owns `slot` and reports it.        *
+  * Returns the NUMA node used, or -1 when not pinned.        *
+  *************************************************************
+*/
+int affinity_bind_thread(int slot, const char *role) {
+    if (policy == AffinityPolicyNone || num_cpus == 0) return -1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    int node;
+    if (policy == AffinityPolicyNuma) {
+        node = node_ids[slot % num_nodes];
+        for (int i = 0; i < num_cpus; i++) {
+            if (cpus[i].node == node) CPU_SET(cpus[i].cpu, &set);
+        }
+    } else {
+        const CpuInfo *info = &cpus[slot % num_cpus];
+        node = info->node;
+        CPU_SET(info->cpu, &set);
+    }
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        fprintf(stderr, "CPU affinity: could not pin %s %d: %s\n", role, slot, strerror(rc));
+        return -1;
+    }
+    prefer_local_memory(node);
+    if (policy == AffinityPolicyNuma) {
+        printf("CPU affinity: %s %d -> node %d\n", role, slot, node);
+    } else {
+        printf("CPU affinity: %s %d -> cpu %d (node %d)\n", role, slot, cpus[slot % num_cpus].cpu, node);
+    }
+    return node;
+}
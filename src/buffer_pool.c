@@ -0,0 +1,196 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "buffer_pool.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Every buffer handed out carries a small header in front of it so that it can be
+ * returned to the right free list without the caller tracking its capacity.
+ */
+typedef union PoolBlock {
+    struct {
+        union PoolBlock *next;
+        size_t capacity;
+        int size_class;
+    } hdr;
+    max_align_t align;
+} PoolBlock;
+
+typedef struct {
+    PoolBlock *free_list[BUFFER_POOL_NUM_CLASSES];
+    size_t retained_bytes;
+} ThreadBufferPool;
+
+static _Thread_local ThreadBufferPool tl_pool;
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Maps a requested size to the smallest class that fits,    *
+  * or -1 if it is larger than the biggest class.             *
+  *************************************************************
+*/
+static int size_class_for(size_t size) {
+    size_t capacity = BUFFER_POOL_MIN_SIZE;
+    for (int i = 0; i < BUFFER_POOL_NUM_CLASSES; i++) {
+        if (size <= capacity) return i;
+        capacity <<= 2;
+    }
+    return -1;
+}
+
+static char *block_data(PoolBlock *block) {
+    return (char *)(block + 1);
+}
+
+static PoolBlock *block_of(char *buf) {
+    return (PoolBlock *)buf - 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Hands out a buffer of at least min_size bytes, reusing a  *
+  * cached one of the matching size class when available.     *
+  *************************************************************
+*/
+char *buffer_pool_acquire(size_t min_size, size_t *out_capacity) {
+    int size_class = size_class_for(min_size);
+    PoolBlock *block;
+    if (size_class >= 0 && tl_pool.free_list[size_class]) {
+        block = tl_pool.free_list[size_class];
+        tl_pool.free_list[size_class] = block->hdr.next;
+        tl_pool.retained_bytes -= block->hdr.capacity;
+    } else {
+        size_t capacity = size_class >= 0 ? (size_t)BUFFER_POOL_MIN_SIZE << (2 * size_class) : min_size;
+        block = malloc(sizeof(PoolBlock) + capacity);
+        if (!block) return NULL;
+        block->hdr.capacity = capacity;
+        block->hdr.size_class = size_class;
+    }
+    block->hdr.next = NULL;
+    if (out_capacity) *out_capacity = block->hdr.capacity;
+    return block_data(block);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * realloc() replacement: moves the first `used` bytes into  *
+  * a buffer of at least min_size and releases the old one.   *
+  *************************************************************
+*/
+char *buffer_pool_grow(char *buf, size_t used, size_t min_size, size_t *out_capacity) {
+    if (buf && block_of(buf)->hdr.capacity >= min_size) {
+        if (out_capacity) *out_capacity = block_of(buf)->hdr.capacity;
+        return buf;
+    }
+    // at least double so repeated small growths stay amortized
+    size_t wanted = buf ? block_of(buf)->hdr.capacity * 2 : 0;
+    if (wanted < min_size) wanted = min_size;
+    char *grown = buffer_pool_acquire(wanted, out_capacity);
+    if (!grown) return NULL;
+    if (buf) {
+        memcpy(grown, buf, used);
+        buffer_pool_release(buf);
+    }
+    return grown;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Returns a buffer to the calling thread's pool. Oversized  *
+  * buffers, and any that would push the pool past its high-  *
+  * water mark, go back to the allocator instead.             *
+  *************************************************************
+*/
+void buffer_pool_release(char *buf) {
+    if (!buf) return;
+    PoolBlock *block = block_of(buf);
+    int size_class = block->hdr.size_class;
+    if (size_class < 0 || tl_pool.retained_bytes + block->hdr.capacity > BUFFER_POOL_HIGH_WATER) {
+        free(block);
+        return;
+    }
+    block->hdr.next = tl_pool.free_list[size_class];
+    tl_pool.free_list[size_class] = block;
+    tl_pool.retained_bytes += block->hdr.capacity;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Frees everything cached by the calling thread. Call this  *
+  * before a worker thread exits.                             *
+  *************************************************************
+*/
+void buffer_pool_thread_cleanup(void) {
+    for (int i = 0; i < BUFFER_POOL_NUM_CLASSES; i++) {
+        PoolBlock *block = tl_pool.free_list[i];
+        while (block) {
+            PoolBlock *next = block->hdr.next;
+            free(block);
+            block = next;
+        }
+        tl_pool.free_list[i] = NULL;
+    }
+    tl_pool.retained_bytes = 0;
+}
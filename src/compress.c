@@ -0,0 +1,247 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "compress.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static int compress_level = Z_DEFAULT_COMPRESSION;
+
+// one deflate state per thread and encoding, reset between bodies rather than rebuilt
+static __thread z_stream thread_streams[HTTP_ENCODING_COUNT];
+static __thread int thread_stream_ready[HTTP_ENCODING_COUNT];
+
+/* A qvalue ("1", "0.5", "0.125") in thousandths. */
+static int parse_qvalue(const char *p) {
+    if (*p == '1') return 1000;
+    if (*p != '0') return 0;
+    int q = 0;
+    int scale = 100;
+    if (*++p == '.') {
+        for (p++; *p >= '0' && *p <= '9' && scale; p++, scale /= 10) q += (*p - '0') * scale;
+    }
+    return q;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Picks the coding for a response from Accept-Encoding,     *
+  * honouring q-values and "*". gzip wins a tie; identity is  *
+  * used when neither gzip nor deflate is acceptable.         *
+  *************************************************************
+*/
+HttpEncoding http_negotiate_encoding(const char *accept_encoding) {
+    if (!accept_encoding) return HTTP_ENCODING_IDENTITY;
+    int q[HTTP_ENCODING_COUNT] = { -1, -1, -1 };
+    int any = -1;
+    const char *p = accept_encoding;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        const char *name = p;
+        while (*p && *p != ',' && *p != ';' && *p != ' ' && *p != '\t') p++;
+        size_t name_len = p - name;
+        int value = 1000;
+        // parameters up to the next comma; only q matters
+        while (*p && *p != ',') {
+            if (*p == ';') {
+                p++;
+                while (*p == ' ' || *p == '\t') p++;
+                if ((*p == 'q' || *p == 'Q') && p[1] == '=') value = parse_qvalue(p + 2);
+                continue;
+            }
+            p++;
+        }
+        if (name_len == 1 && *name == '*') any = value;
+        else if ((name_len == 4 && strncasecmp(name, "gzip", 4) == 0) || (name_len == 6 && strncasecmp(name, "x-gzip", 6) == 0)) q[HTTP_ENCODING_GZIP] = value;
+        else if (name_len == 7 && strncasecmp(name, "deflate", 7) == 0) q[HTTP_ENCODING_DEFLATE] = value;
+    }
+    for (int i = HTTP_ENCODING_GZIP; i < HTTP_ENCODING_COUNT; i++) {
+        if (q[i] < 0) q[i] = any > 0 ? any : 0;
+    }
+    if (q[HTTP_ENCODING_GZIP] > 0 && q[HTTP_ENCODING_GZIP] >= q[HTTP_ENCODING_DEFLATE]) return HTTP_ENCODING_GZIP;
+    if (q[HTTP_ENCODING_DEFLATE] > 0) return HTTP_ENCODING_DEFLATE;
+    return HTTP_ENCODING_IDENTITY;
+}
+
+const char *http_encoding_name(HttpEncoding encoding) {
+    switch (encoding) {
+    case HTTP_ENCODING_GZIP: return "gzip";
+    case HTTP_ENCODING_DEFLATE: return "deflate";
+    default: return "identity";
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Whether a media type is worth compressing: text, JSON,    *
+  * JavaScript, XML and SVG. Images, archives and other       *
+  * already compressed formats are left alone.                *
+  *************************************************************
+*/
+int http_compressible_type(const char *content_type) {
+    if (!content_type) return 1;  // the handlers' text/plain default
+    size_t len = strcspn(content_type, ";");
+    while (len && content_type[len - 1] == ' ') len--;
+    if (len > 5 && strncasecmp(content_type, "text/", 5) == 0) return 1;
+    static const char *const types[] = {
+        "application/json", "application/javascript", "application/xml", "application/xhtml+xml",
+        "application/manifest+json", "application/wasm", "image/svg+xml",
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (strlen(types[i]) == len && strncasecmp(content_type, types[i], len) == 0) return 1;
+    }
+    // structured syntax suffixes, e.g. application/problem+json
+    return (len > 5 && strncasecmp(content_type + len - 5, "+json", 5) == 0) ||
+           (len > 4 && strncasecmp(content_type + len - 4, "+xml", 4) == 0);
+}
+
+void http_compress_set_level(int level) {
+    if (level >= Z_NO_COMPRESSION && level <= Z_BEST_COMPRESSION) compress_level = level;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Compresses a whole body in one deflate call into a        *
+  * buffer of deflateBound() size. "deflate" is the zlib      *
+  * format, as HTTP defines it. Returns -1 if zlib fails or   *
+  * the result would not be smaller than the input.           *
+  *************************************************************
+*/
+int http_compress(HttpEncoding encoding, const char *input, size_t input_len, char **output, size_t *output_len) {
+    if (encoding != HTTP_ENCODING_GZIP && encoding != HTTP_ENCODING_DEFLATE) return -1;
+    if (input_len > UINT_MAX) return -1;
+    z_stream *zs = &thread_streams[encoding];
+    if (!thread_stream_ready[encoding]) {
+        // 16 over the window bits asks for the gzip wrapper
+        int window_bits = encoding == HTTP_ENCODING_GZIP ? 15 + 16 : 15;
+        memset(zs, 0, sizeof(*zs));
+        if (deflateInit2(zs, compress_level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) return -1;
+        thread_stream_ready[encoding] = 1;
+    } else if (deflateReset(zs) != Z_OK) {
+        return -1;
+    }
+    uLong bound = deflateBound(zs, input_len);
+    char *out = malloc(bound);
+    if (!out) return -1;
+    zs->next_in = (Bytef *)input;
+    zs->avail_in = (uInt)input_len;
+    zs->next_out = (Bytef *)out;
+    zs->avail_out = (uInt)bound;
+    if (deflate(zs, Z_FINISH) != Z_STREAM_END || zs->total_out >= input_len) {
+        free(out);
+        return -1;
+    }
+    *output = out;
+    *output_len = zs->total_out;
+    return 0;
+}
+
+/* Frees the calling thread's deflate states. */
+void http_compress_thread_cleanup(void) {
+    for (int i = 0; i < HTTP_ENCODING_COUNT; i++) {
+        if (!thread_stream_ready[i]) continue;
+        deflateEnd(&thread_streams[i]);
+        thread_stream_ready[i] = 0;
+    }
+}
+
+/* Runs a job on the calling thread, for when there is no pool to take it. */
+void compress_run(CompressJob *job) {
+    job->output = NULL;
+    job->output_len = 0;
+    if (job->input) {
+        http_compress(job->encoding, job->input, job->input_len, &job->output, &job->output_len);
+        return;
+    }
+    char *data = malloc(job->input_len ? job->input_len : 1);
+    size_t done = 0;
+    while (data && done < job->input_len) {
+        ssize_t n = pread(job->input_fd, data + done, job->input_len - done, job->input_off + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += n;
+    }
+    if (data && done == job->input_len) http_compress(job->encoding, data, done, &job->output, &job->output_len);
+    free(data);
+}
+
+static void compress_job_run(PoolJob *job, void *worker) {
+    (void)worker;
+    compress_run((CompressJob *)job);
+}
+
+static void compress_thread_stop(void *worker) {
+    (void)worker;
+    http_compress_thread_cleanup();
+}
+
+static JobPool pool = {
+    .thread_stop = compress_thread_stop,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .ready_cond = PTHREAD_COND_INITIALIZER,
+};
+
+int compress_pool_start(int threads) {
+    if (threads <= 0) return 0;
+    return job_pool_start(&pool, threads) > 0 ? 0 : -1;
+}
+
+void compress_pool_stop(void) {
+    job_pool_stop(&pool);
+}
+
+/* Queues a job for the pool. -1 if there is no pool; the caller then compresses it itself. */
+int compress_submit(CompressJob *job, JobCompletions *done) {
+    job->job.run = compress_job_run;
+    job->job.done = done;
+    return job_pool_submit(&pool, &job->job);
+}
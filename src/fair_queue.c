@@ -0,0 +1,370 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "fair_queue.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define FAIR_QUEUE_MIN_BUCKETS 64
+
+typedef struct FairEntry {
+    FairQueueItem item;
+    unsigned long long seq;
+} FairEntry;
+
+typedef struct FairFlow {
+    char key[FAIR_QUEUE_KEY_SIZE];
+    uint32_t hash;
+    struct FairFlow *hash_next;
+    struct FairFlow *active_next;
+    FairEntry *heap;
+    size_t size, capacity;
+    size_t deficit;
+} FairFlow;
+
+struct FairQueue {
+    size_t quantum;
+    size_t size;
+    unsigned long long seq;
+    FairFlow **buckets;
+    size_t bucket_count;
+    size_t flow_count;
+    // flows with queued items, served round robin from the head
+    FairFlow *active_head, *active_tail;
+    int head_credited;
+};
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Flow table: FNV-1a over the key, chained buckets that     *
+  * double once the table is twice as full as it is wide.     *
+  *************************************************************
+*/
+static uint32_t hash_key(const char *key) {
+    uint32_t hash = 2166136261u;
+    for (; *key; key++) {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static FairFlow *find_flow(const FairQueue *fq, const char *key, uint32_t hash) {
+    for (FairFlow *flow = fq->buckets[hash & (fq->bucket_count - 1)]; flow; flow = flow->hash_next) {
+        if (flow->hash == hash && strcmp(flow->key, key) == 0) return flow;
+    }
+    return NULL;
+}
+
+static void grow_buckets(FairQueue *fq) {
+    size_t count = fq->bucket_count * 2;
+    FairFlow **buckets = calloc(count, sizeof(FairFlow *));
+    if (!buckets) return;
+    for (size_t i = 0; i < fq->bucket_count; i++) {
+        FairFlow *flow = fq->buckets[i];
+        while (flow) {
+            FairFlow *next = flow->hash_next;
+            flow->hash_next = buckets[flow->hash & (count - 1)];
+            buckets[flow->hash & (count - 1)] = flow;
+            flow = next;
+        }
+    }
+    free(fq->buckets);
+    fq->buckets = buckets;
+    fq->bucket_count = count;
+}
+
+static void remove_flow(FairQueue *fq, FairFlow *flow) {
+    FairFlow **link = &fq->buckets[flow->hash & (fq->bucket_count - 1)];
+    while (*link != flow) link = &(*link)->hash_next;
+    *link = flow->hash_next;
+    fq->flow_count--;
+    free(flow->heap);
+    free(flow);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Per-flow binary min-heap on (order, seq)                  *
+  *************************************************************
+*/
+static int entry_before(const FairEntry *a, const FairEntry *b) {
+    if (a->item.order != b->item.order) return a->item.order < b->item.order;
+    return a->seq < b->seq;
+}
+
+static int heap_push(FairFlow *flow, FairEntry entry) {
+    if (flow->size == flow->capacity) {
+        size_t capacity = flow->capacity ? flow->capacity * 2 : 4;
+        FairEntry *heap = realloc(flow->heap, capacity * sizeof(FairEntry));
+        if (!heap) return -1;
+        flow->heap = heap;
+        flow->capacity = capacity;
+    }
+    size_t i = flow->size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!entry_before(&entry, &flow->heap[parent])) break;
+        flow->heap[i] = flow->heap[parent];
+        i = parent;
+    }
+    flow->heap[i] = entry;
+    return 0;
+}
+
+static FairEntry heap_pop(FairFlow *flow) {
+    FairEntry top = flow->heap[0];
+    FairEntry last = flow->heap[--flow->size];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= flow->size) break;
+        if (child + 1 < flow->size && entry_before(&flow->heap[child + 1], &flow->heap[child])) child++;
+        if (!entry_before(&flow->heap[child], &last)) break;
+        flow->heap[i] = flow->heap[child];
+        i = child;
+    }
+    flow->heap[i] = last;
+    return top;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Creates an empty queue. quantum is the credit each flow   *
+  * receives per round, in the same unit as item costs.       *
+  *************************************************************
+*/
+FairQueue *fair_queue_create(size_t quantum) {
+    FairQueue *fq = calloc(1, sizeof(FairQueue));
+    if (!fq) return NULL;
+    fq->quantum = quantum ? quantum : 1;
+    fq->bucket_count = FAIR_QUEUE_MIN_BUCKETS;
+    fq->buckets = calloc(fq->bucket_count, sizeof(FairFlow *));
+    if (!fq->buckets) {
+        free(fq);
+        return NULL;
+    }
+    return fq;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Frees the queue. Items still queued are dropped; the      *
+  * caller owns whatever their fd and data refer to.          *
+  *************************************************************
+*/
+void fair_queue_destroy(FairQueue *fq) {
+    if (!fq) return;
+    for (size_t i = 0; i < fq->bucket_count; i++) {
+        FairFlow *flow = fq->buckets[i];
+        while (flow) {
+            FairFlow *next = flow->hash_next;
+            free(flow->heap);
+            free(flow);
+            flow = next;
+        }
+    }
+    free(fq->buckets);
+    free(fq);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queues an item on its flow, creating the flow and adding  *
+  * it to the end of the round if it was idle.                *
+  * Returns 0 on success, -1 if out of memory.                *
+  *************************************************************
+*/
+int fair_queue_push(FairQueue *fq, const char *flow_key, const FairQueueItem *item) {
+    char key[FAIR_QUEUE_KEY_SIZE];
+    snprintf(key, sizeof(key), "%s", flow_key ? flow_key : "");
+    uint32_t hash = hash_key(key);
+    FairFlow *flow = find_flow(fq, key, hash);
+    if (!flow) {
+        flow = calloc(1, sizeof(FairFlow));
+        if (!flow) return -1;
+        memcpy(flow->key, key, sizeof(key));
+        flow->hash = hash;
+        if (fq->flow_count >= fq->bucket_count * 2) grow_buckets(fq);
+        size_t bucket = hash & (fq->bucket_count - 1);
+        flow->hash_next = fq->buckets[bucket];
+        fq->buckets[bucket] = flow;
+        fq->flow_count++;
+    }
+    FairEntry entry = { *item, fq->seq++ };
+    if (heap_push(flow, entry) < 0) {
+        if (flow->size == 0) remove_flow(fq, flow);
+        return -1;
+    }
+    if (flow->size == 1) {
+        flow->active_next = NULL;
+        if (fq->active_tail) fq->active_tail->active_next = flow;
+        else fq->active_head = flow;
+        fq->active_tail = flow;
+    }
+    fq->size++;
+    return 0;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Takes the next item in DRR order. The head flow is        *
+  * credited one quantum when its turn starts and keeps the   *
+  * turn while its next item still fits the remaining credit. *
+  * An emptied flow is forgotten, credit included.            *
+  * Returns 0 with the item in *out, or -1 if empty.          *
+  *************************************************************
+*/
+int fair_queue_pop(FairQueue *fq, FairQueueItem *out) {
+    for (;;) {
+        FairFlow *flow = fq->active_head;
+        if (!flow) return -1;
+        if (!fq->head_credited) {
+            flow->deficit += fq->quantum;
+            fq->head_credited = 1;
+        }
+        if (flow->heap[0].item.cost <= flow->deficit) {
+            FairEntry entry = heap_pop(flow);
+            flow->deficit -= entry.item.cost;
+            fq->size--;
+            if (flow->size == 0) {
+                fq->active_head = flow->active_next;
+                if (!fq->active_head) fq->active_tail = NULL;
+                fq->head_credited = 0;
+                remove_flow(fq, flow);
+            }
+            *out = entry.item;
+            return 0;
+        }
+        // turn over: move to the back of the round, keeping the unused credit
+        if (flow->active_next) {
+            fq->active_head = flow->active_next;
+            flow->active_next = NULL;
+            fq->active_tail->active_next = flow;
+            fq->active_tail = flow;
+        }
+        fq->head_credited = 0;
+    }
+}
+
+size_t fair_queue_size(const FairQueue *fq) {
+    return fq->size;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Number of items the given flow currently has queued       *
+  *************************************************************
+*/
+size_t fair_queue_flow_size(const FairQueue *fq, const char *flow_key) {
+    char key[FAIR_QUEUE_KEY_SIZE];
+    snprintf(key, sizeof(key), "%s", flow_key ? flow_key : "");
+    FairFlow *flow = find_flow(fq, key, hash_key(key));
+    return flow ? flow->size : 0;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Flow key for a socket: the peer's address without port,   *
+  * so all connections from one client share a flow.          *
+  *************************************************************
+*/
+void fair_queue_peer_key(int fd, char *key, size_t key_size) {
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    key[0] = '\0';
+    if (getpeername(fd, (struct sockaddr *)&addr, &len) < 0) return;
+    if (addr.ss_family == AF_INET) {
+        inet_ntop(AF_INET, &((struct sockaddr_in *)&addr)->sin_addr, key, key_size);
+    } else if (addr.ss_family == AF_INET6) {
+        inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&addr)->sin6_addr, key, key_size);
+    }
+}
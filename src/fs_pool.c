@@ -0,0 +1,173 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "fs_pool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// largest file readFile returns; V8 strings cannot hold much more
+#define FS_READ_MAX (256 * 1024 * 1024)
+
+static JobPool pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .ready_cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* A job for op on path; for a write, data holds the len bytes to write and is copied. */
+FsJob *fs_job_create(FsOp op, const char *path, const char *data, size_t len) {
+    FsJob *job = calloc(1, sizeof(FsJob));
+    if (!job) return NULL;
+    job->op = op;
+    job->path = strdup(path);
+    if (data) {
+        job->data = malloc(len ? len : 1);
+        if (job->data) memcpy(job->data, data, len);
+        job->len = len;
+    }
+    if (!job->path || (data && !job->data)) {
+        fs_job_free(job);
+        return NULL;
+    }
+    return job;
+}
+
+/* Frees the job and its buffers; the resolver is the caller's to release. */
+void fs_job_free(FsJob *job) {
+    if (!job) return;
+    free(job->path);
+    free(job->data);
+    free(job);
+}
+
+const char *fs_op_name(FsOp op) {
+    switch (op) {
+    case FS_READ_FILE: return "readFile";
+    case FS_WRITE_FILE: return "writeFile";
+    case FS_STAT: return "stat";
+    }
+    return "fs";
+}
+
+static int read_file(FsJob *job) {
+    int fd = open(job->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (fstat(fd, &job->st) < 0) goto fail;
+    if (S_ISDIR(job->st.st_mode)) {
+        errno = EISDIR;
+        goto fail;
+    }
+    // the size is a hint: files under /proc report 0 and grow as they are read
+    size_t capacity = S_ISREG(job->st.st_mode) && job->st.st_size > 0 ? (size_t)job->st.st_size + 1 : 4096;
+    if (capacity > FS_READ_MAX + 1) {
+        errno = EFBIG;
+        goto fail;
+    }
+    job->data = malloc(capacity);
+    if (!job->data) goto fail;
+    for (;;) {
+        if (job->len == capacity) {
+            if (capacity > FS_READ_MAX) {
+                errno = EFBIG;
+                goto fail;
+            }
+            char *grown = realloc(job->data, capacity * 2);
+            if (!grown) goto fail;
+            job->data = grown;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, job->data + job->len, capacity - job->len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) goto fail;
+        if (n == 0) break;
+        job->len += n;
+    }
+    close(fd);
+    return 0;
+fail:;
+    int error = errno;
+    close(fd);
+    free(job->data);
+    job->data = NULL;
+    job->len = 0;
+    errno = error;
+    return -1;
+}
+
+static int write_file(FsJob *job) {
+    int fd = open(job->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    size_t done = 0;
+    while (done < job->len) {
+        ssize_t n = write(fd, job->data + done, job->len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return -1;
+        }
+        done += n;
+    }
+    return close(fd);
+}
+
+/* Runs a job on the calling thread, for when there is no pool to take it. */
+void fs_run(FsJob *job) {
+    int rc = -1;
+    switch (job->op) {
+    case FS_READ_FILE:
+        rc = read_file(job);
+        break;
+    case FS_WRITE_FILE:
+        rc = write_file(job);
+        break;
+    case FS_STAT:
+        rc = stat(job->path, &job->st);
+        break;
+    }
+    job->error = rc < 0 ? errno : 0;
+}
+
+static void fs_job_run(PoolJob *job, void *worker) {
+    (void)worker;
+    fs_run((FsJob *)job);
+}
+
+int fs_pool_start(int threads) {
+    if (threads <= 0) return 0;
+    return job_pool_start(&pool, threads) > 0 ? 0 : -1;
+}
+
+void fs_pool_stop(void) {
+    job_pool_stop(&pool);
+}
+
+/* Queues a job for the pool. -1 if there is no pool; the caller then runs it itself. */
+int fs_submit(FsJob *job, JobCompletions *done) {
+    job->job.run = fs_job_run;
+    job->job.done = done;
+    return job_pool_submit(&pool, &job->job);
+}
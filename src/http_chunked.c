@@ -0,0 +1,187 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "http_chunked.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// longest chunk-size or trailer line, extensions included
+#define HTTP_CHUNK_LINE_MAX 4096
+#define HTTP_CHUNK_TRAILER_MAX (16 * 1024)
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Tells how the body of a request is framed. A chunked      *
+  * body must have chunked as its last transfer coding, and   *
+  * a request with both Transfer-Encoding and Content-Length  *
+  * is refused rather than guessed at, so a proxy in front    *
+  * cannot see different request boundaries than we do.       *
+  *************************************************************
+*/
+/* A Content-Length value: decimal digits between optional whitespace. Too large a value saturates. */
+static int content_length_value(const char *value, const char *end, size_t *length) {
+    while (value < end && (*value == ' ' || *value == '\t')) value++;
+    if (value == end || !isdigit((unsigned char)*value)) return -1;
+    char *digits_end;
+    errno = 0;
+    unsigned long long parsed = strtoull(value, &digits_end, 10);
+    if (errno == ERANGE || parsed > SIZE_MAX) parsed = SIZE_MAX;
+    while (digits_end < end && (*digits_end == ' ' || *digits_end == '\t' || *digits_end == '\r')) digits_end++;
+    if (digits_end != end) return -1;
+    *length = (size_t)parsed;
+    return 0;
+}
+
+HttpBodyFraming http_body_framing(const char *headers, size_t header_len, size_t *content_length) {
+    const char *p = headers;
+    const char *end = headers + header_len;
+    int has_length = 0, has_coding = 0, chunked = 0, bad_length = 0;
+    *content_length = 0;
+    while (p < end) {
+        const char *eol = memchr(p, '\n', end - p);
+        if (!eol) break;
+        if (eol - p > 15 && strncasecmp(p, "Content-Length:", 15) == 0) {
+            if (content_length_value(p + 15, eol, content_length) < 0) bad_length = 1;
+            has_length = 1;
+        } else if (eol - p > 18 && strncasecmp(p, "Transfer-Encoding:", 18) == 0) {
+            // the codings are listed in the order they were applied, chunked has to come last
+            const char *value_end = eol;
+            while (value_end > p + 18 && (value_end[-1] == '\r' || value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+            const char *coding = value_end;
+            while (coding > p + 18 && coding[-1] != ',' && coding[-1] != ':' && coding[-1] != ' ' && coding[-1] != '\t') coding--;
+            chunked = value_end - coding == 7 && strncasecmp(coding, "chunked", 7) == 0;
+            has_coding = 1;
+        }
+        p = eol + 1;
+    }
+    if (bad_length) return HTTP_BODY_INVALID;
+    if (!has_coding) return HTTP_BODY_LENGTH;
+    if (!chunked || has_length) return HTTP_BODY_INVALID;
+    return HTTP_BODY_CHUNKED;
+}
+
+void http_chunked_init(HttpChunkedDecoder *decoder, size_t body_start, size_t max_body) {
+    *decoder = (HttpChunkedDecoder){
+        .state = HTTP_CHUNK_SIZE,
+        .start = body_start,
+        .in = body_start,
+        .out = body_start,
+        .max_body = max_body,
+    };
+}
+
+/* A chunk-size line: hex digits, then optional extensions, which are ignored. */
+static HttpChunkedStatus chunk_size_line(HttpChunkedDecoder *decoder, const char *line, size_t len) {
+    size_t size = 0, i = 0;
+    for (; i < len && isxdigit((unsigned char)line[i]); i++) {
+        if (size > SIZE_MAX >> 4) return HTTP_CHUNKED_TOO_LARGE;
+        int digit = isdigit((unsigned char)line[i]) ? line[i] - '0' : tolower((unsigned char)line[i]) - 'a' + 10;
+        size = size << 4 | digit;
+    }
+    if (!i || (i < len && line[i] != ';' && line[i] != ' ' && line[i] != '\t')) return HTTP_CHUNKED_INVALID;
+    if (size > decoder->max_body - (decoder->out - decoder->start)) return HTTP_CHUNKED_TOO_LARGE;
+    decoder->left = size;
+    decoder->state = size ? HTTP_CHUNK_DATA : HTTP_CHUNK_TRAILER;
+    return HTTP_CHUNKED_MORE;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Decodes the bytes of buf that arrived since the last      *
+  * call. Chunk data moves down to out as it comes in, and    *
+  * whatever cannot be decoded yet (a partial size line, or   *
+  * once done the next request) is moved down behind it, so   *
+  * *len shrinks by the framing and the buffer never holds    *
+  * more than the body plus one line. buf is terminated at    *
+  * the new *len. Trailers are dropped.                       *
+  *************************************************************
+*/
+HttpChunkedStatus http_chunked_decode(HttpChunkedDecoder *decoder, char *buf, size_t *len) {
+    HttpChunkedStatus status = HTTP_CHUNKED_MORE;
+    while (status == HTTP_CHUNKED_MORE && decoder->in < *len) {
+        if (decoder->state == HTTP_CHUNK_DATA) {
+            size_t take = *len - decoder->in < decoder->left ? *len - decoder->in : decoder->left;
+            if (decoder->out != decoder->in) memmove(buf + decoder->out, buf + decoder->in, take);
+            decoder->out += take;
+            decoder->in += take;
+            decoder->left -= take;
+            if (!decoder->left) decoder->state = HTTP_CHUNK_DATA_END;
+            continue;
+        }
+        const char *line = buf + decoder->in;
+        const char *eol = memchr(line, '\n', *len - decoder->in);
+        if (!eol) {
+            if (*len - decoder->in > HTTP_CHUNK_LINE_MAX) status = HTTP_CHUNKED_INVALID;
+            break;
+        }
+        size_t line_len = eol - line;
+        if (line_len && line[line_len - 1] == '\r') line_len--;
+        if (line_len > HTTP_CHUNK_LINE_MAX) {
+            status = HTTP_CHUNKED_INVALID;
+            break;
+        }
+        decoder->in = eol + 1 - buf;
+        switch (decoder->state) {
+        case HTTP_CHUNK_SIZE:
+            status = chunk_size_line(decoder, line, line_len);
+            break;
+        case HTTP_CHUNK_DATA_END:
+            if (line_len) status = HTTP_CHUNKED_INVALID;
+            else decoder->state = HTTP_CHUNK_SIZE;
+            break;
+        case HTTP_CHUNK_TRAILER:
+            // a blank line ends the trailers and the request
+            if (!line_len) status = HTTP_CHUNKED_DONE;
+            else if ((decoder->trailer += line_len) > HTTP_CHUNK_TRAILER_MAX) status = HTTP_CHUNKED_TOO_LARGE;
+            break;
+        case HTTP_CHUNK_DATA:
+            break;
+        }
+    }
+    if (status == HTTP_CHUNKED_INVALID || status == HTTP_CHUNKED_TOO_LARGE || decoder->in == decoder->out) return status;
+    size_t rest = *len - decoder->in;
+    memmove(buf + decoder->out, buf + decoder->in, rest);
+    decoder->in = decoder->out;
+    *len = decoder->out + rest;
+    buf[*len] = '\0';
+    return status;
+}
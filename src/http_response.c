@@ -0,0 +1,131 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "http_response.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "utils.h"
+
+#define STATUS_MIN 100
+#define STATUS_MAX 599
+// "HTTP/1.1 511 " and a reason phrase
+#define STATUS_LINE_SIZE 64
+
+static char status_lines[STATUS_MAX - STATUS_MIN + 1][STATUS_LINE_SIZE];
+static unsigned char status_line_lens[STATUS_MAX - STATUS_MIN + 1];
+static pthread_once_t status_lines_once = PTHREAD_ONCE_INIT;
+
+static __thread char date_header[HTTP_DATE_HEADER_LEN + 1];
+static __thread time_t date_second = -1;
+
+static void build_status_lines(void) {
+    for (int status = STATUS_MIN; status <= STATUS_MAX; status++) {
+        int len = snprintf(status_lines[status - STATUS_MIN], STATUS_LINE_SIZE, "HTTP/1.1 %d %s\r\n", status,
+                           http_status_text(status));
+        status_line_lens[status - STATUS_MIN] = (unsigned char)len;
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * The status line for a code, CRLF included. Lines are      *
+  * built once for every code from 100 to 599; a handler that *
+  * returns anything else gets a 500.                         *
+  *************************************************************
+*/
+const char *http_status_line(int status, size_t *len) {
+    pthread_once(&status_lines_once, build_status_lines);
+    if (status < STATUS_MIN || status > STATUS_MAX) status = 500;
+    *len = status_line_lens[status - STATUS_MIN];
+    return status_lines[status - STATUS_MIN];
+}
+
+/* Reformats the calling thread's Date line if the second has changed since it was made. */
+void http_date_refresh(void) {
+    struct timespec ts;
+    // not the coarse clock: called just after a second begins, that may still show the last one
+    clock_gettime(CLOCK_REALTIME, &ts);
+    if (ts.tv_sec == date_second) return;
+    struct tm tm;
+    gmtime_r(&ts.tv_sec, &tm);
+    strftime(date_header, sizeof(date_header), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm);
+    date_second = ts.tv_sec;
+}
+
+/*
+ * The calling thread's Date line, HTTP_DATE_HEADER_LEN bytes. It is only as current as the
+ * thread's last http_date_refresh(), and stays valid until the next one.
+ */
+const char *http_date_header(void) {
+    if (date_second < 0) http_date_refresh();
+    return date_header;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Points iov at the pieces of a response in the order they  *
+  * go out, and returns how many there are: three for a head  *
+  * alone, four with a body. Nothing is copied, so the        *
+  * response must outlive the write.                          *
+  *************************************************************
+*/
+int http_response_iov(const HttpResponse *response, struct iovec iov[HTTP_RESPONSE_IOV]) {
+    size_t status_len;
+    const char *status_line = http_status_line(response->status, &status_len);
+    int count = 0;
+    iov[count++] = (struct iovec){ (void *)status_line, status_len };
+    iov[count++] = (struct iovec){ (void *)http_date_header(), HTTP_DATE_HEADER_LEN };
+    iov[count++] = (struct iovec){ response->headers, response->headers_len };
+    if (response->body && response->body_len) iov[count++] = (struct iovec){ response->body, response->body_len };
+    return count;
+}
+
+size_t http_response_length(const HttpResponse *response) {
+    size_t status_len;
+    http_status_line(response->status, &status_len);
+    return status_len + HTTP_DATE_HEADER_LEN + response->headers_len + (response->body ? response->body_len : 0);
+}
+
+void http_response_free(HttpResponse *response) {
+    free(response->headers);
+    free(response->body);
+    response->headers = response->body = NULL;
+}
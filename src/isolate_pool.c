@@ -0,0 +1,85 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "isolate_pool.h"
+
+#include <stdio.h>
+
+#include "affinity.h"
+#include "compress.h"
+
+static V8Engine *pool_parent;
+static int pool_first_slot;
+
+// set on the pool's threads, whose isolates are not driven by a reactor
+static __thread int on_worker = 0;
+
+/* Loads the app script into an isolate of the calling pool thread; NULL if it fails. */
+static void *isolate_thread_start(int index) {
+    on_worker = 1;
+    // bind first so the isolate heap is allocated on the worker's node
+    affinity_bind_thread(pool_first_slot + index, "handler");
+    V8Engine *engine = v8_create_isolate(pool_parent);
+    if (!engine) fprintf(stderr, "Handler worker %d: could not load the app script\n", index);
+    return engine;
+}
+
+static void isolate_thread_stop(void *worker) {
+    // handlers compress small bodies on the worker
+    http_compress_thread_cleanup();
+    v8_dispose_isolate(worker);
+}
+
+static JobPool pool = {
+    .thread_start = isolate_thread_start,
+    .thread_stop = isolate_thread_stop,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .ready_cond = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * Starts the workers and waits until each has loaded the app script. Their cpus follow
+ * ASP_AFFINITY from first_slot on. Returns the number of workers that are running.
+ */
+int isolate_pool_start(V8Engine *parent, int threads, int first_slot) {
+    pool_parent = parent;
+    pool_first_slot = first_slot;
+    return job_pool_start(&pool, threads);
+}
+
+void isolate_pool_stop(void) {
+    job_pool_stop(&pool);
+}
+
+int isolate_pool_size(void) {
+    return job_pool_size(&pool);
+}
+
+/* Whether the caller is one of the pool's threads. */
+int isolate_pool_on_worker(void) {
+    return on_worker;
+}
+
+/* Queues a job for the pool. -1 if there is no pool; the caller then runs it itself. */
+int isolate_pool_submit(PoolJob *job) {
+    return job_pool_submit(&pool, job);
+}
@@ -0,0 +1,170 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "job_pool.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Pool thread: sets itself up, then runs queued jobs in     *
+  * order and hands each one back to its reactor. Once        *
+  * stopping, it drains the queue before it exits, so every   *
+  * job is completed.                                         *
+  *************************************************************
+*/
+static void *job_worker(void *arg) {
+    JobPool *pool = arg;
+    pthread_mutex_lock(&pool->lock);
+    int index = pool->entered++;
+    pthread_mutex_unlock(&pool->lock);
+    void *worker = pool->thread_start ? pool->thread_start(index) : NULL;
+    int ready = !pool->thread_start || worker;
+    pthread_mutex_lock(&pool->lock);
+    pool->reported++;
+    if (ready) pool->size++;
+    pthread_cond_broadcast(&pool->ready_cond);
+    pthread_mutex_unlock(&pool->lock);
+    if (!ready) return NULL;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->head && !pool->stopping) pthread_cond_wait(&pool->cond, &pool->lock);
+        PoolJob *job = pool->head;
+        if (job) {
+            pool->head = job->next;
+            if (!pool->head) pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (!job) break;
+
+        job->run(job, worker);
+        JobCompletions *done = job->done;
+        pthread_mutex_lock(&done->lock);
+        job->next = done->head;
+        done->head = job;
+        pthread_mutex_unlock(&done->lock);
+        uint64_t one = 1;
+        if (write(done->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) perror("write eventfd");
+    }
+    if (pool->thread_stop) pool->thread_stop(worker);
+    return NULL;
+}
+
+/* Starts the threads and waits until each has set up. Returns the number taking jobs. */
+int job_pool_start(JobPool *pool, int threads) {
+    if (threads <= 0) return 0;
+    pool->threads = calloc(threads, sizeof(pthread_t));
+    if (!pool->threads) return 0;
+    pool->stopping = 0;
+    for (pool->started = 0; pool->started < threads; pool->started++) {
+        if (pthread_create(&pool->threads[pool->started], NULL, job_worker, pool) != 0) {
+            perror("pthread_create");
+            break;
+        }
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (pool->reported < pool->started) pthread_cond_wait(&pool->ready_cond, &pool->lock);
+    int size = pool->size;
+    pthread_mutex_unlock(&pool->lock);
+    return size;
+}
+
+void job_pool_stop(JobPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->started; i++) pthread_join(pool->threads[i], NULL);
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->started = pool->entered = pool->reported = pool->size = 0;
+}
+
+int job_pool_size(JobPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    int size = pool->stopping ? 0 : pool->size;
+    pthread_mutex_unlock(&pool->lock);
+    return size;
+}
+
+/* Queues a job for the pool. -1 if there is no pool; the caller then runs it itself. */
+int job_pool_submit(JobPool *pool, PoolJob *job) {
+    pthread_mutex_lock(&pool->lock);
+    int running = pool->size > 0 && !pool->stopping;
+    if (running) {
+        job->next = NULL;
+        if (pool->tail) pool->tail->next = job;
+        else pool->head = job;
+        pool->tail = job;
+        pthread_cond_signal(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return running ? 0 : -1;
+}
+
+int job_completions_init(JobCompletions *done) {
+    done->head = NULL;
+    done->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (done->event_fd < 0) {
+        perror("eventfd");
+        return -1;
+    }
+    pthread_mutex_init(&done->lock, NULL);
+    return 0;
+}
+
+void job_completions_destroy(JobCompletions *done) {
+    if (done->event_fd < 0) return;
+    close(done->event_fd);
+    done->event_fd = -1;
+    pthread_mutex_destroy(&done->lock);
+}
+
+/* Takes every finished job, oldest first, and resets the eventfd. */
+PoolJob *job_completions_take(JobCompletions *done) {
+    uint64_t count;
+    if (read(done->event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) perror("read eventfd");
+    pthread_mutex_lock(&done->lock);
+    PoolJob *jobs = done->head;
+    done->head = NULL;
+    pthread_mutex_unlock(&done->lock);
+    PoolJob *ordered = NULL;
+    while (jobs) {
+        PoolJob *next = jobs->next;
+        jobs->next = ordered;
+        ordered = jobs;
+        jobs = next;
+    }
+    return ordered;
+}
@@ -21,6 +21,12 @@
 
 #include "m3__multi_threaded_server.h"
 
+#include "affinity.h"
+#include "buffer_pool.h"
+#include "fair_queue.h"
+#include "http_chunked.h"
+#include "http_response.h"
+#include "socket_tuning.h"
 #include "utils.h"
 #include <pthread.h>
 #include <stdio.h>
@@ -28,46 +34,198 @@
 #include <string.h>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/resource.h>
 #include <signal.h>
 #include <stdint.h>
 #include <time.h>
 #include <errno.h>
+#include <strings.h>
+#include <ctype.h>
 
 #define MAX_QUEUE 128
 #define DEFAULT_THREADS 4
 #define MAX_THREADS 64
 #define BUFFER_SIZE 1024
+#define DEFAULT_KEEP_ALIVE_TIMEOUT 5
+#define DEFAULT_KEEP_ALIVE_MAX 100
+#define MAX_IDLE_EVENTS 64
+#define IDLE_SWEEP_MS 250
+#define DEFAULT_HEADER_TIMEOUT_MS 10000
+#define DEFAULT_BODY_TIMEOUT_MS 30000
+#define DEFAULT_MIN_RECV_RATE 1024
+#define MIN_RATE_GRACE_MS 1000
+// a larger Content-Length is refused before any of it is read, a chunked body is cut off here
+#define MAX_REQUEST_BODY (8 * 1024 * 1024)
+#define READ_STALL_MS 10
+#define DEFAULT_QUEUE_BUDGET_MS 1000
+#define DEFAULT_PRIORITY_PATHS "/health,/healthz,/ready,/readyz,/livez,/telemetry"
+#define DEADLINE_HEADER "X-Request-Deadline-Ms"
+#define PEEK_SIZE 1024
+#define DEFAULT_FAIR_QUANTUM 4096
+// off: DRR already keeps one flow from delaying the others, and a proxy or NAT is one peer
+#define DEFAULT_FAIR_FLOW_LIMIT 0
 
 typedef struct {
     char *method;
     char *body;
     size_t size;
+    char *if_none_match;
+    int keep_alive;
+    int keep_alive_timeout;
+    int keep_alive_max;
 } MtHttpRequest;
 
+typedef enum MtReadStatus {
+    MtReadDone,
+    MtReadPending,  // the client stalled, the state is kept for a later resume
+    MtReadTimeout,
+    MtReadError,
+    MtReadInvalid,   // malformed body framing, answered with 400
+    MtReadTooLarge,  // a body over MAX_REQUEST_BODY, answered with 413
+} MtReadStatus;
+
+typedef struct MtReadLimits {
+    int header_timeout_ms;
+    int body_timeout_ms;
+    int min_recv_rate;  // bytes per second, 0 disables the check
+} MtReadLimits;
+
+/*
+ * A request that is being received. Deadlines are absolute monotonic_ms() values.
+ */
+typedef struct MtReadState {
+    char *buf;
+    size_t len, capacity;
+    size_t header_len, expected;
+    size_t extra;  // bytes read past the end of the request
+    int chunked;
+    HttpChunkedDecoder decoder;  // decodes a chunked body in buf, in place
+    long long header_deadline;
+    long long body_started;
+} MtReadState;
+
+/*
+ * Per-fd bookkeeping for persistent connections. Parked connections (idle between
+ * requests or stalled mid-request) are linked in deadline order, so the head expires first.
+ */
+typedef struct MtConnState {
+    int requests;
+    int idle;
+    int idle_prev, idle_next;
+    long long idle_deadline;
+    MtReadState read;
+} MtConnState;
+
+typedef enum MtAcceptMode {
+    MtAcceptQueue,      // one dispatcher thread accepts and hands fds through the queue
+    MtAcceptReusePort,  // every worker accepts on its own SO_REUSEPORT socket
+} MtAcceptMode;
+
+/*
+ * Connections wait in one of these lanes. A lane is only served when every
+ * higher-priority lane is empty, so probes never queue behind user traffic.
+ */
+typedef enum MtLane {
+    MtLaneControl,  // health checks and telemetry scrapes
+    MtLaneNormal,
+    MT_NUM_LANES,
+} MtLane;
+
+/*
+ * Each lane is a FairQueue: deficit round robin across client flows, earliest
+ * deadline first within a flow. Item order is the deadline (monotonic_ms()),
+ * flags carry MT_ENTRY_HAS_DEADLINE when the client sent DEADLINE_HEADER.
+ */
+#define MT_ENTRY_HAS_DEADLINE 1
+
 typedef struct ThreadPool {
-    int conn_queue[MAX_QUEUE];
-    int queue_head, queue_tail, queue_size;
+    FairQueue *lanes[MT_NUM_LANES];
+    int queue_size;
+    const char *priority_paths;
+    int queue_budget_ms;
+    int fair_by_peer;
+    const char *fair_header;  // flow key header, falls back to the peer address
+    int fair_flow_limit;
     pthread_mutex_t queue_mutex;
     pthread_cond_t queue_cond;
+    pthread_cond_t queue_not_full;
     pthread_t threads[MAX_THREADS];
     int num_threads;
     volatile sig_atomic_t running;
     int server_fd;
+    int keep_alive_timeout;
+    int keep_alive_max;
+    MtConnState *conns;
+    int max_conns;
+    int idle_head, idle_tail;
+    pthread_mutex_t idle_mutex;
+    int idle_epoll_fd;
+    pthread_t idle_thread;
+    MtAcceptMode accept_mode;
+    int wake_fd;
 } ThreadPool;
 
+static MtReadLimits read_limits = {
+    DEFAULT_HEADER_TIMEOUT_MS,
+    DEFAULT_BODY_TIMEOUT_MS,
+    DEFAULT_MIN_RECV_RATE,
+};
+
 typedef struct WorkerArgs {
     V8Engine *engine;
     struct ThreadPool *pool;
+    int index;
+    int listen_fd;
 } WorkerArgs;
 
 struct WorkerRequestData {
     V8Engine *engine;
     char *buffer;
-    char *response_buffer;
-    size_t response_size;
+    HttpResponse response;  // headers NULL if none was made
+    int keep_alive;
+    int keep_alive_timeout;
+    int keep_alive_max;
 };
 
+static void classify_conn(ThreadPool *pool, int fd, MtLane *lane, FairQueueItem *item, char *flow, size_t flow_size);
+static void send_bare_response(int fd, int status);
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Per-fd state of a freshly accepted connection, and the    *
+  * close of one that is not parked. Closing releases a       *
+  * half-read request, so the next connection that gets the   *
+  * fd number does not resume it.                             *
+  *************************************************************
+*/
+static void conn_state_reset(ThreadPool *pool, int fd) {
+    if (fd < pool->max_conns) pool->conns[fd] = (MtConnState){ .idle_prev = -1, .idle_next = -1 };
+}
+
+static void close_conn(ThreadPool *pool, int fd) {
+    if (fd < pool->max_conns) {
+        MtConnState *conn = &pool->conns[fd];
+        buffer_pool_release(conn->read.buf);
+        memset(&conn->read, 0, sizeof(conn->read));
+        conn->idle = 0;
+    }
+    close(fd);
+}
+
 /**
  *   __  __
  *  |  \/  |
@@ -77,7 +235,11 @@ struct WorkerRequestData {
  *  |_|  |_| M3
  *
  * Adds a connection file descriptor to the thread pool's connection queue.
- * If the queue is full, the function waits until space is available.
+ * If the queue is full, the function waits until space is available, or with
+ * wait == 0 answers 503 and closes the connection instead, so a caller that must
+ * keep running (the idle watcher, or a worker accepting in reuseport mode) never
+ * blocks on the workers.
+ * The connection is classified into a priority lane first (see classify_conn).
  *
  * Useful APIs and system calls:
  *   - pthread_mutex_lock()   : Lock a mutex for exclusive access.
@@ -85,18 +247,42 @@ struct WorkerRequestData {
  *   - pthread_mutex_unlock() : Unlock a mutex.
  *   - pthread_cond_signal()  : Signal a condition variable.
  */
-static void enqueue_conn(ThreadPool *pool, int connfd) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void enqueue_conn(ThreadPool *pool, int connfd, int wait) {
+    // classify outside the lock, the peek is a syscall
+    MtLane lane;
+    FairQueueItem item;
+    char flow[FAIR_QUEUE_KEY_SIZE];
+    classify_conn(pool, connfd, &lane, &item, flow, sizeof(flow));
+    pthread_mutex_lock(&pool->queue_mutex);
+    // with a limit set, a single client may only hold its share of the queue, the rest is refused up front
+    int rejected = lane == MtLaneNormal && pool->fair_flow_limit > 0 &&
+                   fair_queue_flow_size(pool->lanes[lane], flow) >= (size_t)pool->fair_flow_limit;
+    while (!rejected && pool->queue_size == MAX_QUEUE && pool->running) {
+        if (!wait) {
+            rejected = 1;
+            break;
+        }
+        pthread_cond_wait(&pool->queue_not_full, &pool->queue_mutex);
+    }
+    if (!pool->running) {
+        pthread_mutex_unlock(&pool->queue_mutex);
+        close_conn(pool, connfd);
+        return;
+    }
+    if (rejected || fair_queue_push(pool->lanes[lane], flow, &item) < 0) {
+        pthread_mutex_unlock(&pool->queue_mutex);
+        send_bare_response(connfd, 503);
+        telemetry_increment_fair_rejects();
+        close_conn(pool, connfd);
+        return;
+    }
+    pool->queue_size++;
+    pthread_cond_signal(&pool->queue_cond);
+    pthread_mutex_unlock(&pool->queue_mutex);
+    if (pool->wake_fd >= 0) {
+        uint64_t one = 1;
+        if (write(pool->wake_fd, &one, sizeof(one)) < 0) perror("eventfd write");
+    }
 }
 
 /**
@@ -109,6 +295,8 @@ static void enqueue_conn(ThreadPool *pool, int connfd) {
  *
  * Removes and returns a connection file descriptor from the thread pool's connection queue.
  * If the queue is empty, the function waits until a connection is available or the server is stopped.
+ * The entry comes from the highest-priority non-empty lane, in that lane's fair-queue order.
+ * Returns 0 with the entry in *out, or -1 once the server has stopped.
  *
  * Useful APIs and system calls:
  *   - pthread_mutex_lock()   : Locks a mutex for exclusive access.
@@ -116,18 +304,140 @@ static void enqueue_conn(ThreadPool *pool, int connfd) {
  *   - pthread_mutex_unlock() : Unlock a mutex.
  *   - pthread_cond_signal()  : Signal a condition variable.
  */
-static int dequeue_conn(ThreadPool *pool) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static int dequeue_conn(ThreadPool *pool, FairQueueItem *out) {
+    pthread_mutex_lock(&pool->queue_mutex);
+    while (pool->queue_size == 0 && pool->running) {
+        pthread_cond_wait(&pool->queue_cond, &pool->queue_mutex);
+    }
+    if (pool->queue_size == 0) {
+        pthread_mutex_unlock(&pool->queue_mutex);
+        return -1;
+    }
+    for (int lane = 0; lane < MT_NUM_LANES; lane++) {
+        if (fair_queue_pop(pool->lanes[lane], out) == 0) break;
+    }
+    pool->queue_size--;
+    pthread_cond_signal(&pool->queue_not_full);
+    pthread_mutex_unlock(&pool->queue_mutex);
+    return 0;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Returns the length of the header block including the      *
+  * blank line, or 0 if it has not been fully received yet.   *
+  *************************************************************
+*/
+static size_t find_header_end(const char *buf, size_t len) {
+    for (size_t i = 0; i + 1 < len; i++) {
+        if (buf[i] != '\n') continue;
+        if (buf[i + 1] == '\n') return i + 2;
+        if (i + 2 < len && buf[i + 1] == '\r' && buf[i + 2] == '\n') return i + 3;
+    }
+    return 0;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Looks up a header (case-insensitive) in a header block    *
+  * and returns its trimmed value, or NULL if absent.         *
+  *************************************************************
+*/
+static const char *find_header_value(const char *headers, size_t header_len, const char *name, size_t *value_len) {
+    size_t name_len = strlen(name);
+    const char *end = headers + header_len;
+    // skip the request line
+    const char *p = memchr(headers, '\n', header_len);
+    while (p && ++p < end) {
+        const char *eol = memchr(p, '\n', end - p);
+        if (!eol) break;
+        if ((size_t)(eol - p) > name_len && p[name_len] == ':' && strncasecmp(p, name, name_len) == 0) {
+            const char *value = p + name_len + 1;
+            while (value < eol && (*value == ' ' || *value == '\t')) value++;
+            const char *value_end = eol;
+            while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ')) value_end--;
+            *value_len = value_end - value;
+            return value;
+        }
+        p = eol;
+    }
+    return NULL;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Extracts the Content-Length value from a header block.    *
+  *************************************************************
+*/
+static size_t parse_content_length(const char *headers, size_t header_len) {
+    size_t value_len = 0;
+    const char *value = find_header_value(headers, header_len, "Content-Length", &value_len);
+    if (!value) return 0;
+    if (!value_len || !isdigit((unsigned char)*value)) return 0;
+    char *end;
+    unsigned long long length = strtoull(value, &end, 10);
+    if (end != value + value_len || length > SIZE_MAX) return 0;
+    return (size_t)length;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * HTTP/1.1 connections persist unless the client sends      *
+  * "Connection: close"; HTTP/1.0 ones only when it asks for  *
+  * "Connection: keep-alive".                                 *
+  *************************************************************
+*/
+static int has_token(const char *value, size_t len, const char *token) {
+    size_t token_len = strlen(token);
+    for (size_t i = 0; i + token_len <= len; i++) {
+        if (strncasecmp(value + i, token, token_len) == 0) return 1;
+    }
+    return 0;
+}
+
+static int request_wants_keep_alive(const char *raw_request, size_t header_len) {
+    const char *eol = memchr(raw_request, '\n', header_len);
+    size_t line_len = eol ? (size_t)(eol - raw_request) : header_len;
+    int keep_alive = !has_token(raw_request, line_len, "HTTP/1.0");
+    size_t value_len = 0;
+    const char *value = find_header_value(raw_request, header_len, "Connection", &value_len);
+    if (value) {
+        if (has_token(value, value_len, "close")) keep_alive = 0;
+        else if (has_token(value, value_len, "keep-alive")) keep_alive = 1;
+    }
+    return keep_alive;
 }
 
 /**
@@ -146,23 +456,33 @@ static int dequeue_conn(ThreadPool *pool) {
  *        a. Search for the end of the HTTP headers ("\r\n\r\n") to locate the start of the body.
  *        b. If a body is present, calculate the body length.
  *        c. If a "Content-Length" header is present, use its value as the body length.
+ *   A chunked body has already been decoded by the read path, so it is read like any other.
  *
  * Useful APIs and system calls:
  *   - Memory management: memset(), malloc(), free()
  *   - String manipulation and parsing: sscanf(), strstr(), strncpy(), strlen(), strtol()
  */
 void parse_http_request_url(V8Engine *engine, const char *raw_request, MtHttpRequest *request) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    (void)engine;
+    memset(request, 0, sizeof(*request));
+    char method[16];
+    if (sscanf(raw_request, "%15s", method) != 1) return;
+    request->method = strdup(method);
+    size_t raw_len = strlen(raw_request);
+    size_t header_len = find_header_end(raw_request, raw_len);
+    request->keep_alive = request_wants_keep_alive(raw_request, header_len ? header_len : raw_len);
+    size_t value_len = 0;
+    const char *if_none_match = find_header_value(raw_request, header_len ? header_len : raw_len, "If-None-Match", &value_len);
+    if (if_none_match) request->if_none_match = strndup(if_none_match, value_len);
+    if (!header_len || header_len >= raw_len) return;
+    size_t body_len = raw_len - header_len;
+    size_t content_length = parse_content_length(raw_request, header_len);
+    if (content_length && content_length < body_len) body_len = content_length;
+    request->body = malloc(body_len + 1);
+    if (!request->body) return;
+    memcpy(request->body, raw_request + header_len, body_len);
+    request->body[body_len] = '\0';
+    request->size = body_len;
 }
 
 /*
@@ -244,18 +564,84 @@ JSObject create_js_request_object(V8Engine *engine, const MtHttpRequest *request
  *   - v8_get_string_property()           : Gets a string property from a JS object.
  *   - snprintf(), strdup()               : String manipulation.
  */
-void handle_request_url(V8Engine *engine, const MtHttpRequest *request, char **response_buffer, size_t *response_size) {
-    /**
-    ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-    ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-    ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-    ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-    ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-    ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-    ━━━━━━━━━━━━━━━━━━━━━
-    ━━━ Your code here...
-    ━━━━━━━━━━━━━━━━━━━━━
-    */
+void handle_request_url(V8Engine *engine, MtHttpRequest *request, HttpResponse *response) {
+    *response = (HttpResponse){ 0 };
+    int status = 500;
+    char *content_type = NULL;
+    char *connection = NULL;
+    char *body = NULL;
+    JSObject req_obj = create_js_request_object(engine, request);
+    if (req_obj && v8_get_registered_handler_func(engine)) {
+        JSResult res = v8_call_registered_handler_obj(engine, req_obj);
+        if (res.success && res.type == JS_OBJECT && res.value.obj_result) {
+            JSObject res_obj = res.value.obj_result;
+            int ok = 0;
+            int js_status = v8_get_number_property(engine, res_obj, "status", &ok);
+            status = ok ? js_status : 200;
+            JSObject headers = v8_get_object_property(engine, res_obj, "headers");
+            if (headers) {
+                content_type = (char *)v8_get_string_property(engine, headers, "Content-Type");
+                connection = (char *)v8_get_string_property(engine, headers, "Connection");
+                v8_free_object(headers);
+            }
+            body = (char *)v8_get_string_property(engine, res_obj, "body");
+            v8_free_object(res_obj);
+        } else if (res.type == JS_STRING) {
+            free(res.value.str_result);
+        }
+    }
+    if (req_obj) v8_free_object(req_obj);
+
+    // the handler may force the connection closed
+    if (connection && strcasecmp(connection, "close") == 0) request->keep_alive = 0;
+    if (!body && status >= 400) body = strdup(http_status_text(status));
+    size_t body_len = body ? strlen(body) : 0;
+    int is_head = strcmp(request->method, "HEAD") == 0;
+    char keep_alive_hdr[64] = "";
+    if (request->keep_alive) {
+        snprintf(keep_alive_hdr, sizeof(keep_alive_hdr), "Keep-Alive: timeout=%d, max=%d\r\n",
+                 request->keep_alive_timeout, request->keep_alive_max);
+    }
+    // a strong validator for 200s to GET and HEAD; a client that already has this body gets a 304
+    char etag_hdr[HTTP_ETAG_SIZE + 8] = "";
+    if (status == 200 && (is_head || strcmp(request->method, "GET") == 0)) {
+        char etag[HTTP_ETAG_SIZE];
+        http_etag(body ? body : "", body_len, etag, sizeof(etag));
+        snprintf(etag_hdr, sizeof(etag_hdr), "ETag: %s\r\n", etag);
+        if (request->if_none_match && http_etag_matches(request->if_none_match, strlen(request->if_none_match), etag)) {
+            status = 304;
+        }
+    }
+    // the status line and Date come from the shared serializer; this is the rest of the head
+    const char *format =
+        "Content-Type: %s\r\n"
+        "Content-Length: %zu\r\n"
+        "%s"
+        "Server: asp-v8/1.0\r\n"
+        "Connection: %s\r\n"
+        "%s"
+        "\r\n";
+    // a 304 keeps the length the 200 would have had, as RFC 9110 allows, but sends no body
+    if (status == 304) is_head = 1;
+    const char *type = content_type ? content_type : "text/plain";
+    const char *conn = request->keep_alive ? "keep-alive" : "close";
+    int header_len = snprintf(NULL, 0, format, type, body_len, etag_hdr, conn, keep_alive_hdr);
+    char *headers = malloc(header_len + 1);
+    if (headers) {
+        snprintf(headers, header_len + 1, format, type, body_len, etag_hdr, conn, keep_alive_hdr);
+        response->status = status;
+        response->headers = headers;
+        response->headers_len = header_len;
+        // the handler's string is sent as it is
+        if (!is_head) {
+            response->body = body;
+            response->body_len = body_len;
+            body = NULL;
+        }
+    }
+    free(content_type);
+    free(connection);
+    free(body);
 }
 
 /*
@@ -276,7 +662,18 @@ int process_request(void *data) {
     V8Engine *engine = d->engine;
     MtHttpRequest request;
     parse_http_request_url(engine, d->buffer, &request);
-    handle_request_url(engine, &request, &d->response_buffer, &d->response_size);
+    if (!request.method) {
+        d->keep_alive = 0;
+        return 0;
+    }
+    request.keep_alive = request.keep_alive && d->keep_alive;
+    request.keep_alive_timeout = d->keep_alive_timeout;
+    request.keep_alive_max = d->keep_alive_max;
+    handle_request_url(engine, &request, &d->response);
+    d->keep_alive = request.keep_alive;
+    free(request.method);
+    free(request.body);
+    free(request.if_none_match);
     return 0;
 }
 
@@ -302,23 +699,184 @@ int process_request(void *data) {
  *   - listen()         : Mark the socket as passive to accept connections.
  *   - close()          : Close the socket on error.
  *
+ * With reuse_port set, SO_REUSEPORT is enabled so that several sockets can bind the
+ * same port and the kernel spreads incoming connections across them. The socket
+ * profile from socket_tuning.h is applied before listen(), and sets the backlog.
+ *
  * Returns:
  *   On success: file descriptor of the listening socket.
  *   On failure: -1.
  */
-int create_and_bind_socket_mt(int port) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-    return 0;
+int create_and_bind_socket_mt(int port, int reuse_port) {
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    int opt = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt");
+        close(server_fd);
+        return -1;
+    }
+    if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT");
+        close(server_fd);
+        return -1;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        perror("bind");
+        close(server_fd);
+        return -1;
+    }
+    // by default only wake accept() once the request has arrived, so the queue can peek at it
+    socket_tune_listener(server_fd, 1);
+    if (listen(server_fd, socket_tuning_backlog()) < 0) {
+        perror("listen");
+        close(server_fd);
+        return -1;
+    }
+    return server_fd;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Read deadlines. The headers must arrive within            *
+  * header_timeout_ms. The body gets body_timeout_ms and      *
+  * must also keep up with min_recv_rate after a short        *
+  * grace period, so a client that drips one byte at a time   *
+  * cannot hold a request open indefinitely.                  *
+  *************************************************************
+*/
+static void read_state_reset(MtReadState *st) {
+    memset(st, 0, sizeof(*st));
+    st->header_deadline = monotonic_ms() + read_limits.header_timeout_ms;
+}
+
+static long long read_state_deadline(const MtReadState *st) {
+    if (!st->header_len) return st->header_deadline;
+    long long deadline = st->body_started + read_limits.body_timeout_ms;
+    if (read_limits.min_recv_rate > 0) {
+        // the moment the body received so far falls below the minimum rate
+        long long allowed = (long long)(st->len - st->header_len) * 1000 / read_limits.min_recv_rate;
+        if (allowed < MIN_RATE_GRACE_MS) allowed = MIN_RATE_GRACE_MS;
+        if (st->body_started + allowed < deadline) deadline = st->body_started + allowed;
+    }
+    return deadline;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Receives as much of the request as arrives in time.       *
+  * Waits at most stall_ms for each chunk (-1 waits until     *
+  * the deadline) and returns MtReadPending if the client     *
+  * went quiet, so the caller can resume later from st. A     *
+  * chunked body is decoded as it arrives, so a finished      *
+  * request looks like one sent with Content-Length.          *
+  *************************************************************
+*/
+static MtReadStatus read_request_step(int connfd, MtReadState *st, int stall_ms) {
+    if (!st->buf) {
+        st->buf = buffer_pool_acquire(BUFFER_SIZE, &st->capacity);
+        if (!st->buf) return MtReadError;
+    }
+    while (!st->header_len || st->len < st->expected) {
+        long long remaining = read_state_deadline(st) - monotonic_ms();
+        if (remaining <= 0) return MtReadTimeout;
+        int wait_ms = stall_ms >= 0 && stall_ms < remaining ? stall_ms : (int)remaining;
+        struct pollfd pfd = { .fd = connfd, .events = POLLIN };
+        int ready = poll(&pfd, 1, wait_ms);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return MtReadError;
+        }
+        if (ready == 0) {
+            if (wait_ms < remaining) return MtReadPending;
+            continue;
+        }
+        // keep one byte for the terminator
+        if (st->len + 1 >= st->capacity) {
+            char *grown = buffer_pool_grow(st->buf, st->len, st->capacity * 2, &st->capacity);
+            if (!grown) return MtReadError;
+            st->buf = grown;
+        }
+        // never read past this request, the rest belongs to the next one
+        size_t want = st->capacity - st->len - 1;
+        if (st->header_len && want > st->expected - st->len) want = st->expected - st->len;
+        ssize_t n = read(connfd, st->buf + st->len, want);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return MtReadError;
+        }
+        if (n == 0) break;
+        st->len += n;
+        st->buf[st->len] = '\0';
+        if (!st->header_len) {
+            st->header_len = find_header_end(st->buf, st->len);
+            if (st->header_len) {
+                size_t content_length;
+                HttpBodyFraming framing = http_body_framing(st->buf, st->header_len, &content_length);
+                if (framing == HTTP_BODY_INVALID) return MtReadInvalid;
+                if (framing == HTTP_BODY_LENGTH && content_length > MAX_REQUEST_BODY) return MtReadTooLarge;
+                st->body_started = monotonic_ms();
+                st->chunked = framing == HTTP_BODY_CHUNKED;
+                if (st->chunked) {
+                    // the end is only known once the last chunk is in
+                    http_chunked_init(&st->decoder, st->header_len, MAX_REQUEST_BODY);
+                    st->expected = SIZE_MAX;
+                } else {
+                    st->expected = st->header_len + content_length;
+                }
+                // size the buffer for the whole body in one step
+                if (!st->chunked && st->expected + 1 > st->capacity) {
+                    char *grown = buffer_pool_grow(st->buf, st->len, st->expected + 1, &st->capacity);
+                    if (!grown) return MtReadError;
+                    st->buf = grown;
+                }
+            }
+        }
+        if (st->chunked && st->expected == SIZE_MAX) {
+            switch (http_chunked_decode(&st->decoder, st->buf, &st->len)) {
+            case HTTP_CHUNKED_MORE:
+                break;
+            case HTTP_CHUNKED_DONE:
+                // what follows is the next request; it is dropped, as the connection then closes
+                st->extra = st->len - st->decoder.out;
+                st->len = st->expected = st->decoder.out;
+                st->buf[st->len] = '\0';
+                break;
+            case HTTP_CHUNKED_INVALID:
+                return MtReadInvalid;
+            case HTTP_CHUNKED_TOO_LARGE:
+                return MtReadTooLarge;
+            }
+        }
+    }
+    // the client hung up in the middle of a chunked body
+    if (st->chunked && st->expected == SIZE_MAX) return MtReadError;
+    if (st->header_len && st->len > st->expected) st->extra = st->len - st->expected;
+    return st->len ? MtReadDone : MtReadError;
 }
 
 /**
@@ -338,6 +896,9 @@ int create_and_bind_socket_mt(int port) {
  *   2. Read the HTTP headers.
  *   3. Handle "Content-Length" if present.
  *   4. Implement a timeout mechanism to avoid hanging on slow or unresponsive clients.
+ *      The header and body deadlines from read_limits apply; on expiry errno is ETIMEDOUT.
+ *   A chunked body is decoded in place. Malformed framing fails with EINVAL, a body
+ *   over MAX_REQUEST_BODY with EFBIG, before a declared length is read.
  *   5. Ensure the entire request (headers + body) is read.
  *   6. Handle errors and disconnections gracefully.
  *   7. Return the complete request data and its length.
@@ -348,22 +909,67 @@ int create_and_bind_socket_mt(int port) {
  *   - Strings: strstr(), strlen(), strcpy(), strncpy()
  *
  * Returns:
- *   On success: pointer to the buffer containing the request (must be freed by caller).
+ *   On success: pointer to the buffer containing the request (release with buffer_pool_release()).
  *   On failure: NULL.
  */
 char *read_full_request(int connfd, size_t *out_len) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-    return NULL;
+    MtReadState st;
+    read_state_reset(&st);
+    MtReadStatus status = read_request_step(connfd, &st, -1);
+    if (status != MtReadDone) {
+        buffer_pool_release(st.buf);
+        errno = status == MtReadTimeout ? ETIMEDOUT : status == MtReadInvalid ? EINVAL : status == MtReadTooLarge ? EFBIG : EIO;
+        return NULL;
+    }
+    if (out_len) *out_len = st.len;
+    return st.buf;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Writes the whole buffer, retrying on short writes.        *
+  *************************************************************
+*/
+static int write_all(int fd, const char *buf, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = write(fd, buf + sent, len - sent);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        sent += n;
+    }
+    return 0;
+}
+
+/* writev until every piece is out, picking up after short writes. */
+static int writev_all(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
 }
 
 /*
@@ -384,19 +990,249 @@ char *read_full_request(int connfd, size_t *out_len) {
  *   - Socket : write(), close()
  *   - Memory management: free()
  *   - Strings: strlen(), strcpy(), strcat()
+ *
+ * Returns 1 if the connection stays open for keep-alive, 0 if it was closed.
  */
-void create_response(int connfd, char *req_buf, struct WorkerRequestData d) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+int create_response(int connfd, char *req_buf, struct WorkerRequestData d) {
+    int kept = d.keep_alive;
+    if (d.response.headers) {
+        // workers have no timer to do it, so the Date line is checked per response
+        http_date_refresh();
+        struct iovec iov[HTTP_RESPONSE_IOV];
+        int count = http_response_iov(&d.response, iov);
+        if (writev_all(connfd, iov, count) < 0) kept = 0;
+        http_response_free(&d.response);
+    } else {
+        static const char error_response[] =
+            "HTTP/1.1 500 Internal Server Error\r\n"
+            "Content-Type: text/plain\r\n"
+            "Content-Length: 21\r\n"
+            "Connection: close\r\n"
+            "\r\n"
+            "Internal Server Error";
+        write_all(connfd, error_response, sizeof(error_response) - 1);
+        kept = 0;
+    }
+    // the request buffer goes back to this worker's pool for the next connection
+    buffer_pool_release(req_buf);
+    if (!kept) close(connfd);
+    return kept;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Best-effort body-less error response, e.g. a 408 for a    *
+  * client that missed its read deadline. Never blocks; the   *
+  * caller closes the socket.                                 *
+  *************************************************************
+*/
+static void send_bare_response(int fd, int status) {
+    char response[128];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 %d %s\r\n"
+                       "Connection: close\r\n"
+                       "Content-Length: 0\r\n"
+                       "\r\n",
+                       status, http_status_text(status));
+    if (send(fd, response, len, MSG_DONTWAIT | MSG_NOSIGNAL) < 0 && errno != EAGAIN) {
+        perror("send");
+    }
+}
+
+static void send_request_timeout(int fd) {
+    send_bare_response(fd, 408);
+    telemetry_increment_read_timeouts();
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Picks a lane, deadline and fair-queue flow from a         *
+  * non-blocking MSG_PEEK of the request head. Paths listed   *
+  * in priority_paths go to the control lane. DEADLINE_HEADER *
+  * gives the client's remaining budget in milliseconds;      *
+  * without it the entry is ordered as if it had              *
+  * queue_budget_ms and never expires. The flow is the peer   *
+  * address unless fair_header is configured and present.     *
+  *************************************************************
+*/
+static int path_is_priority(const char *paths, const char *path, size_t path_len) {
+    while (*paths) {
+        const char *end = strchr(paths, ',');
+        size_t len = end ? (size_t)(end - paths) : strlen(paths);
+        if (len == path_len && memcmp(paths, path, len) == 0) return 1;
+        if (!end) break;
+        paths = end + 1;
+    }
+    return 0;
+}
+
+static void classify_conn(ThreadPool *pool, int fd, MtLane *lane, FairQueueItem *item, char *flow, size_t flow_size) {
+    long long now = monotonic_ms();
+    *lane = MtLaneNormal;
+    memset(item, 0, sizeof(*item));
+    item->fd = fd;
+    item->order = now + pool->queue_budget_ms;
+    item->cost = PEEK_SIZE;
+    flow[0] = '\0';
+    if (pool->fair_by_peer) fair_queue_peer_key(fd, flow, flow_size);
+    // a resumed partial read has no request line in the socket, only the rest of the request
+    if (fd < pool->max_conns && pool->conns[fd].read.buf) {
+        item->order = now;
+        return;
+    }
+    char peek[PEEK_SIZE];
+    ssize_t n = recv(fd, peek, sizeof(peek) - 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n <= 0) return;
+    peek[n] = '\0';
+    // bigger requests cost more of the client's round
+    item->cost = n;
+
+    const char *path = memchr(peek, ' ', n);
+    if (path) {
+        path++;
+        size_t path_len = strcspn(path, " ?\r\n");
+        if (path_is_priority(pool->priority_paths, path, path_len)) *lane = MtLaneControl;
+    }
+    size_t value_len;
+    size_t header_len = find_header_end(peek, n);
+    if (!header_len) header_len = n;
+    const char *value = find_header_value(peek, header_len, DEADLINE_HEADER, &value_len);
+    if (value && value_len > 0 && value_len < 10 && strspn(value, "0123456789") >= value_len) {
+        item->flags |= MT_ENTRY_HAS_DEADLINE;
+        item->order = now + strtol(value, NULL, 10);
+    }
+    if (pool->fair_header) {
+        value = find_header_value(peek, header_len, pool->fair_header, &value_len);
+        if (value) snprintf(flow, flow_size, "h:%.*s", (int)value_len, value);
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Takes one connection off the queue. A request whose       *
+  * client deadline already passed is answered with 503 and   *
+  * closed before any JS runs.                                *
+  * Returns the fd, -1 once stopped, or -2 if it was dropped. *
+  *************************************************************
+*/
+static int next_conn(ThreadPool *pool) {
+    FairQueueItem item;
+    if (dequeue_conn(pool, &item) < 0) return -1;
+    if (!(item.flags & MT_ENTRY_HAS_DEADLINE) || item.order > monotonic_ms()) return item.fd;
+    send_bare_response(item.fd, 503);
+    telemetry_increment_deadline_drops();
+    close_conn(pool, item.fd);
+    return -2;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Parked connections. Instead of pinning a worker in a      *
+  * blocking read, a connection that is idle between requests *
+  * or stalled mid-request waits in the watcher's epoll set   *
+  * and goes back on the queue once the client sends more     *
+  * data. idle_unlink callers must hold idle_mutex.           *
+  *************************************************************
+*/
+static void idle_unlink(ThreadPool *pool, int fd) {
+    MtConnState *conn = &pool->conns[fd];
+    if (conn->idle_prev != -1) pool->conns[conn->idle_prev].idle_next = conn->idle_next;
+    else pool->idle_head = conn->idle_next;
+    if (conn->idle_next != -1) pool->conns[conn->idle_next].idle_prev = conn->idle_prev;
+    else pool->idle_tail = conn->idle_prev;
+    conn->idle = 0;
+    conn->idle_prev = conn->idle_next = -1;
+    epoll_ctl(pool->idle_epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+static void idle_park(ThreadPool *pool, int fd, long long deadline) {
+    MtConnState *conn = &pool->conns[fd];
+    pthread_mutex_lock(&pool->idle_mutex);
+    conn->idle = 1;
+    conn->idle_deadline = deadline;
+    // keep-alive parks append at the tail; only stalled reads with other deadlines walk back
+    int prev = pool->idle_tail;
+    while (prev != -1 && pool->conns[prev].idle_deadline > deadline) prev = pool->conns[prev].idle_prev;
+    conn->idle_prev = prev;
+    conn->idle_next = prev != -1 ? pool->conns[prev].idle_next : pool->idle_head;
+    if (conn->idle_next != -1) pool->conns[conn->idle_next].idle_prev = fd;
+    else pool->idle_tail = fd;
+    if (prev != -1) pool->conns[prev].idle_next = fd;
+    else pool->idle_head = fd;
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.fd = fd };
+    if (epoll_ctl(pool->idle_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("epoll_ctl");
+        idle_unlink(pool, fd);
+        buffer_pool_release(conn->read.buf);
+        conn->read.buf = NULL;
+        close(fd);
+    }
+    pthread_mutex_unlock(&pool->idle_mutex);
+}
+
+static void *idle_watcher_thread(void *arg) {
+    ThreadPool *pool = (ThreadPool *)arg;
+    struct epoll_event events[MAX_IDLE_EVENTS];
+    while (pool->running) {
+        int nfds = epoll_wait(pool->idle_epoll_fd, events, MAX_IDLE_EVENTS, IDLE_SWEEP_MS);
+        for (int i = 0; i < nfds; i++) {
+            int fd = events[i].data.fd;
+            pthread_mutex_lock(&pool->idle_mutex);
+            int was_idle = pool->conns[fd].idle;
+            if (was_idle) idle_unlink(pool, fd);
+            pthread_mutex_unlock(&pool->idle_mutex);
+            if (was_idle) enqueue_conn(pool, fd, 0);
+        }
+        // the list is kept in deadline order, so expired connections sit at the head
+        long long now = monotonic_ms();
+        pthread_mutex_lock(&pool->idle_mutex);
+        while (pool->idle_head != -1 && pool->conns[pool->idle_head].idle_deadline <= now) {
+            int fd = pool->idle_head;
+            MtReadState *st = &pool->conns[fd].read;
+            idle_unlink(pool, fd);
+            if (st->buf) {
+                send_request_timeout(fd);
+                buffer_pool_release(st->buf);
+                st->buf = NULL;
+            }
+            close(fd);
+        }
+        pthread_mutex_unlock(&pool->idle_mutex);
+    }
+    buffer_pool_thread_cleanup();
+    return NULL;
 }
 
 /*
@@ -412,13 +1248,107 @@ void create_response(int connfd, char *req_buf, struct WorkerRequestData d) {
   * Handle a new connection                                   *
   *************************************************************
 */
-void handle_connection_mt(V8Engine *engine, int connfd) {
+void handle_connection_mt(V8Engine *engine, ThreadPool *pool, int connfd) {
+    MtConnState *conn = connfd < pool->max_conns ? &pool->conns[connfd] : NULL;
+    char *req_buf;
     size_t req_len = 0;
-    char *req_buf = read_full_request(connfd, &req_len);
-    if (!req_buf) { close(connfd); return; }
-    struct WorkerRequestData d = { engine, req_buf, NULL, 0 };
-    process_request(&d);
-    create_response(connfd, req_buf, d);
+    if (conn) {
+        if (!conn->read.buf) read_state_reset(&conn->read);
+        MtReadStatus status = read_request_step(connfd, &conn->read, READ_STALL_MS);
+        if (status == MtReadPending) {
+            // a slow client costs a parked socket, not a worker
+            idle_park(pool, connfd, read_state_deadline(&conn->read));
+            return;
+        }
+        req_buf = conn->read.buf;
+        req_len = conn->read.len;
+        conn->read.buf = NULL;
+        if (status != MtReadDone) {
+            if (status == MtReadTimeout) send_request_timeout(connfd);
+            else if (status == MtReadInvalid) send_bare_response(connfd, 400);
+            else if (status == MtReadTooLarge) send_bare_response(connfd, 413);
+            buffer_pool_release(req_buf);
+            close(connfd);
+            return;
+        }
+    } else {
+        req_buf = read_full_request(connfd, &req_len);
+        if (!req_buf) {
+            if (errno == ETIMEDOUT) send_request_timeout(connfd);
+            else if (errno == EINVAL) send_bare_response(connfd, 400);
+            else if (errno == EFBIG) send_bare_response(connfd, 413);
+            close(connfd);
+            return;
+        }
+    }
+    // bytes beyond this request would be lost while parked, so such connections close
+    int pipelined = conn && conn->read.extra;
+    int allow_keep_alive = conn && pool->keep_alive_timeout > 0 && !pipelined &&
+                           conn->requests + 1 < pool->keep_alive_max;
+    struct WorkerRequestData d = {
+        .engine = engine,
+        .buffer = req_buf,
+        .keep_alive = allow_keep_alive,
+        .keep_alive_timeout = pool->keep_alive_timeout,
+        .keep_alive_max = conn ? pool->keep_alive_max - conn->requests - 1 : 0,
+    };
+    invoke_with_v8_locker(engine, process_request, &d);
+    if (!create_response(connfd, req_buf, d)) return;
+    conn->requests++;
+    idle_park(pool, connfd, monotonic_ms() + (long long)pool->keep_alive_timeout * 1000);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Worker loop for SO_REUSEPORT mode. The worker accepts on  *
+  * its own listening socket, so the kernel spreads accepts   *
+  * over the workers. Accepted connections still go through   *
+  * the lanes like everything else, for priority, deadlines   *
+  * and fairness, and are taken by whichever worker is free;  *
+  * wake_fd holds one token per queued fd.                    *
+  *************************************************************
+*/
+static void accept_loop(V8Engine *engine, ThreadPool *pool, int listen_fd) {
+    struct pollfd fds[2] = {
+        { .fd = listen_fd, .events = POLLIN },
+        { .fd = pool->wake_fd, .events = POLLIN },
+    };
+    nfds_t nfds = pool->wake_fd >= 0 ? 2 : 1;
+    while (pool->running) {
+        if (poll(fds, nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (nfds == 2 && (fds[1].revents & POLLIN)) {
+            uint64_t token;
+            if (read(pool->wake_fd, &token, sizeof(token)) == sizeof(token)) {
+                int connfd = next_conn(pool);
+                if (connfd >= 0) handle_connection_mt(engine, pool, connfd);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            // the listening socket is non-blocking; accepted sockets are not
+            int connfd = accept(listen_fd, NULL, NULL);
+            if (connfd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("Accept failed");
+                continue;
+            }
+            socket_tune_accepted(connfd);
+            conn_state_reset(pool, connfd);
+            // the workers drain the queue themselves, so a full one is answered rather than waited on
+            enqueue_conn(pool, connfd, 0);
+        }
+    }
+    close(listen_fd);
 }
 
 /*
@@ -438,11 +1368,19 @@ static void *worker_thread(void *arg) {
     WorkerArgs *args = (WorkerArgs *)arg;
     V8Engine *engine = args->engine;
     ThreadPool *pool = args->pool;
-    while (pool->running) {
-        int connfd = dequeue_conn(pool);
-        if (connfd == -1) break;
-        handle_connection_mt(engine, connfd);
+    // bind first so the worker's pooled buffers are faulted in on its own node;
+    // slot 0 is the main thread, which accepts and dispatches in queue mode
+    affinity_bind_thread(args->index + 1, "worker");
+    if (pool->accept_mode == MtAcceptReusePort) {
+        accept_loop(engine, pool, args->listen_fd);
+    } else {
+        while (pool->running) {
+            int connfd = next_conn(pool);
+            if (connfd == -1) break;
+            if (connfd >= 0) handle_connection_mt(engine, pool, connfd);
+        }
     }
+    buffer_pool_thread_cleanup();
     free(args);
     return NULL;
 }
@@ -461,18 +1399,108 @@ static void *worker_thread(void *arg) {
   *   Pointer to the newly created ThreadPool structure.
 */
 ThreadPool *create_thread_pool(int num_threads) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-    return NULL;
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+    if (num_threads > MAX_THREADS) num_threads = MAX_THREADS;
+    pool->num_threads = num_threads;
+    pool->running = 1;
+    pool->server_fd = -1;
+    pool->idle_epoll_fd = -1;
+    pool->idle_head = pool->idle_tail = -1;
+    pool->wake_fd = -1;
+    pool->priority_paths = config_get_string("ASP_PRIORITY_PATHS", DEFAULT_PRIORITY_PATHS);
+    pool->queue_budget_ms = config_get_int("ASP_QUEUE_BUDGET_MS", DEFAULT_QUEUE_BUDGET_MS);
+    pool->fair_flow_limit = config_get_int("ASP_FAIR_FLOW_LIMIT", DEFAULT_FAIR_FLOW_LIMIT);
+    const char *fair_key = config_get_string("ASP_FAIR_KEY", "peer");
+    pool->fair_by_peer = strcmp(fair_key, "none") != 0;
+    if (strncmp(fair_key, "header:", 7) == 0 && fair_key[7]) pool->fair_header = fair_key + 7;
+    size_t quantum = config_get_int("ASP_FAIR_QUANTUM", DEFAULT_FAIR_QUANTUM);
+    for (int i = 0; i < MT_NUM_LANES; i++) {
+        pool->lanes[i] = fair_queue_create(quantum);
+        if (!pool->lanes[i]) {
+            while (i-- > 0) fair_queue_destroy(pool->lanes[i]);
+            free(pool);
+            return NULL;
+        }
+    }
+    const char *mode = config_get_string("ASP_ACCEPT_MODE", "queue");
+    if (strcmp(mode, "reuseport") == 0) {
+        pool->accept_mode = MtAcceptReusePort;
+    } else if (strcmp(mode, "queue") != 0) {
+        fprintf(stderr, "Unknown ASP_ACCEPT_MODE '%s', using 'queue'\n", mode);
+    }
+    pthread_mutex_init(&pool->queue_mutex, NULL);
+    pthread_cond_init(&pool->queue_cond, NULL);
+    pthread_cond_init(&pool->queue_not_full, NULL);
+    pthread_mutex_init(&pool->idle_mutex, NULL);
+
+    read_limits.header_timeout_ms = config_get_int("ASP_HEADER_TIMEOUT_MS", DEFAULT_HEADER_TIMEOUT_MS);
+    read_limits.body_timeout_ms = config_get_int("ASP_BODY_TIMEOUT_MS", DEFAULT_BODY_TIMEOUT_MS);
+    read_limits.min_recv_rate = config_get_int("ASP_MIN_RECV_RATE", DEFAULT_MIN_RECV_RATE);
+    pool->keep_alive_timeout = config_get_int("ASP_KEEPALIVE_TIMEOUT", DEFAULT_KEEP_ALIVE_TIMEOUT);
+    pool->keep_alive_max = config_get_int("ASP_KEEPALIVE_MAX", DEFAULT_KEEP_ALIVE_MAX);
+    if (pool->keep_alive_max <= 1) pool->keep_alive_timeout = 0;
+
+    // one slot per possible descriptor so connection state is a plain array lookup
+    struct rlimit limit;
+    pool->max_conns = 1024;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        pool->max_conns = (int)limit.rlim_cur;
+    }
+    pool->conns = calloc(pool->max_conns, sizeof(MtConnState));
+    if (pool->conns) {
+        for (int i = 0; i < pool->max_conns; i++) {
+            pool->conns[i].idle_prev = pool->conns[i].idle_next = -1;
+        }
+    }
+    pool->idle_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (pool->accept_mode == MtAcceptReusePort) {
+        // re-queued connections need a wake-up channel into the workers' poll loop
+        pool->wake_fd = eventfd(0, EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    if (!pool->conns || pool->idle_epoll_fd < 0 ||
+        (pool->accept_mode == MtAcceptReusePort && pool->wake_fd < 0) ||
+        pthread_create(&pool->idle_thread, NULL, idle_watcher_thread, pool) != 0) {
+        // fall back to blocking reads without keep-alive
+        perror("connection watcher");
+        free(pool->conns);
+        pool->conns = NULL;
+        pool->max_conns = 0;
+        pool->keep_alive_timeout = 0;
+        if (pool->idle_epoll_fd >= 0) close(pool->idle_epoll_fd);
+        pool->idle_epoll_fd = -1;
+        if (pool->wake_fd >= 0) close(pool->wake_fd);
+        pool->wake_fd = -1;
+    }
+    return pool;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Releases everything owned by the pool                     *
+  *************************************************************
+*/
+static void destroy_thread_pool(ThreadPool *pool) {
+    if (pool->idle_epoll_fd >= 0) {
+        pthread_join(pool->idle_thread, NULL);
+        close(pool->idle_epoll_fd);
+    }
+    pthread_mutex_destroy(&pool->queue_mutex);
+    pthread_cond_destroy(&pool->queue_cond);
+    pthread_cond_destroy(&pool->queue_not_full);
+    pthread_mutex_destroy(&pool->idle_mutex);
+    if (pool->wake_fd >= 0) close(pool->wake_fd);
+    for (int i = 0; i < MT_NUM_LANES; i++) fair_queue_destroy(pool->lanes[i]);
+    free(pool->conns);
+    free(pool);
 }
 
 /*
@@ -491,31 +1519,53 @@ ThreadPool *create_thread_pool(int num_threads) {
 */
 int start_server_mt(V8Engine *engine, int port, int num_threads) {
     if (num_threads <= 0) num_threads = DEFAULT_THREADS;
+    telemetry_init();
     ThreadPool *pool = create_thread_pool(num_threads);
-    int server_fd = create_and_bind_socket_mt(port);
+    if (!pool) return 1;
+    num_threads = pool->num_threads;
+    int reuse_port = pool->accept_mode == MtAcceptReusePort;
+
+    // bind every listening socket up front so a failure is reported before any thread starts
+    int listen_fds[MAX_THREADS];
+    int num_sockets = reuse_port ? num_threads : 1;
+    for (int i = 0; i < num_sockets; ++i) {
+        listen_fds[i] = create_and_bind_socket_mt(port, reuse_port);
+        if (listen_fds[i] < 0 || (reuse_port && fcntl(listen_fds[i], F_SETFL, O_NONBLOCK) < 0)) {
+            if (listen_fds[i] >= 0) close(listen_fds[i]);
+            while (i-- > 0) close(listen_fds[i]);
+            pool->running = 0;
+            destroy_thread_pool(pool);
+            return 1;
+        }
+    }
+    int server_fd = listen_fds[0];
     pool->server_fd = server_fd;
-    if (server_fd < 0) { free(pool); return 1; }
+    server_fd_global = server_fd;
+    printf("Accept mode: %s\n", reuse_port ? "SO_REUSEPORT per worker" : "dispatcher queue");
+
     for (int i = 0; i < num_threads; ++i) {
         WorkerArgs *args = malloc(sizeof(WorkerArgs));
         args->engine = engine;
         args->pool = pool;
+        args->index = i;
+        args->listen_fd = reuse_port ? listen_fds[i] : -1;
         pthread_create(&pool->threads[i], NULL, worker_thread, args);
     }
-    while (pool->running) {
+    while (!reuse_port && pool->running) {
         int new_socket = accept(server_fd, NULL, NULL);
         if (new_socket < 0) {
             if (!pool->running) break;
             perror("Accept failed");
             continue;
         }
-        enqueue_conn(pool, new_socket);
+        socket_tune_accepted(new_socket);
+        conn_state_reset(pool, new_socket);
+        enqueue_conn(pool, new_socket, 1);
     }
     for (int i = 0; i < num_threads; ++i) {
         pthread_join(pool->threads[i], NULL);
     }
-    pthread_mutex_destroy(&pool->queue_mutex);
-    pthread_cond_destroy(&pool->queue_cond);
-    free(pool);
+    destroy_thread_pool(pool);
     printf("Multi-threaded server stopped.\n");
     return 0;
 }
@@ -19,8 +19,23 @@
 * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#define _GNU_SOURCE
+
 #include "m4_5__event_based_server.h"
 
+#include "affinity.h"
+#include "buffer_pool.h"
+#include "compress.h"
+#include "http_chunked.h"
+#include "http_response.h"
+#include "fair_queue.h"
+#include "fs_pool.h"
+#include "isolate_pool.h"
+#include "response_cache.h"
+#include "socket_tuning.h"
+#include "static_files.h"
+#include "timer_wheel.h"
+#include "uring.h"
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -29,14 +44,71 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/epoll.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <time.h>
 #include <sys/timerfd.h>
 #include <ctype.h>
+#include <errno.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/resource.h>
+#include <pthread.h>
+#include <poll.h>
 
-#define MAX_EVENTS 64
+#define MIN_EVENTS 64
+#define MAX_EVENTS 1024
+#define ACCEPT_BUDGET 128
 #define READ_BUFFER_SIZE 1024
+#define INLINE_BUFFER_SIZE 1024
+#define FREE_LIST_MAX 1024
+#define ARENA_KEEP_MAX (64 * 1024)
+#define STATIC_CACHE_FILES 256
+#define MAX_REQUEST_SIZE (8 * 1024 * 1024)
+#define DEFAULT_KEEP_ALIVE_TIMEOUT 5
+#define DEFAULT_KEEP_ALIVE_MAX 100
+#define FD_PRESSURE_RESERVE 64
+#define OUTPUT_HIGH_WATER (256 * 1024)
+#define PIPELINE_DEPTH 32
+#define WRITEV_BATCH 64
+#define DEFAULT_FAIR_QUANTUM 4096
+#define DISPATCH_BATCH 16
+#define DEFAULT_REACTORS 1
+#define DEFAULT_RESPONSE_CACHE_MB 64
+#define DEFAULT_COMPRESS_MIN_BYTES 1024
+#define DEFAULT_COMPRESS_LEVEL 6
+#define DEFAULT_COMPRESS_THREADS 2
+#define DEFAULT_HANDLER_THREADS 0
+#define DEFAULT_FS_THREADS 2
+// bursts a reactor keeps on the handler workers per worker; the rest wait in its fair queue
+#define HANDLER_WINDOW 2
+// bodies at least this large are compressed by the pool rather than on the reactor
+#define COMPRESS_OFFLOAD_BYTES (64 * 1024)
+// an ETag with a coding appended, e.g. "0123456789abcdef-deflate"
+#define VARIANT_ETAG_SIZE 32
+#define JS_TIMER_SLOT_BITS 20
+#define URING_ENTRIES 256
+#define URING_RECV_BUFFERS 256
+#define URING_RECV_BUFFER_SIZE 4096
+#define URING_BUFFER_GROUP 0
+
+// io_uring user_data: the operation in the low bits, the connection's fd and generation
+// above it. A send carries its EvSendOp pointer instead, whose low bits are zero.
+#define URING_OP_SEND 0
+#define URING_OP_ACCEPT 1
+#define URING_OP_RECV 2
+#define URING_OP_TIMER 3
+#define URING_OP_CANCEL 4
+#define URING_OP_WAKE 5
+#define URING_OP_MASK 7
+#define URING_DATA(op, fd, generation) \
+    (((uint64_t)(uint32_t)(fd) << 32) | ((uint64_t)((generation) & 0xffffff) << 8) | (op))
+#define URING_DATA_FD(data) ((int)((data) >> 32))
+#define URING_DATA_GENERATION(data) ((unsigned)((data) >> 8) & 0xffffff)
 
 /**
  *   __  __
@@ -46,16 +118,286 @@
  *  | |  | |
  *  |_|  |_| M4
  *
- * Convenience globals for the event-based server.
- * Ideally, they should not be static, but exposed via a context struct.
- * For simplicity, we keep them static here. Feel free to refactor.
+ * State of the event-based server. Settings shared by all reactors live in EvServer.
+ * Everything a reactor touches while it runs lives in its own EvReactor: its listening
+ * socket, epoll set, timer, isolate and dispatch queue. Reactors share nothing but the
+ * atomic telemetry counters, so they run in parallel without locks.
  */
 static volatile sig_atomic_t server_running_eb = 1;
-static int server_fd_global_eb = -1;
-static JSObject interval_callback = NULL;
-static int timer_fd = -1;
-static int interval_ms = 1000;
 
+typedef struct EvServer EvServer;
+
+// a setInterval or setTimeout; its id is the table slot plus the slot's generation
+typedef struct EvJsTimer {
+    TimerEntry entry;
+    JSObject callback;
+    int interval_ms;  // 0 for a setTimeout
+    unsigned slot;
+    int firing;       // the callback is running, a clear only marks it
+    int cleared;
+} EvJsTimer;
+
+typedef struct EvJsTimerSlot {
+    EvJsTimer *timer;
+    unsigned generation;
+    unsigned next_free;  // slot + 1 of the next free slot, 0 at the end
+} EvJsTimerSlot;
+
+/*
+ * Timers of one reactor. JS timers and internal deadlines share the wheel, and the
+ * reactor's timerfd is armed for its next deadline.
+ */
+typedef struct EvTimers {
+    TimerWheel wheel;
+    EvJsTimerSlot *slots;
+    unsigned capacity;
+    unsigned used;       // slots handed out so far
+    unsigned free_head;  // slot + 1 of the first free slot, 0 if none
+} EvTimers;
+
+typedef enum {
+    EvParseHeaders,  // looking for the blank line that ends the header block
+    EvParseBody,     // headers parsed, waiting for Content-Length body bytes
+    EvParseChunked,  // headers parsed, decoding a chunked body as it arrives
+    EvParseDone,     // a complete request sits at the front of buf
+    EvParseRejected  // the framing is malformed or too large, the client gets reject_status
+} EvParseState;
+
+// a queued piece of output, written from off onwards. With file set it is a file range,
+// or, if data is set too, a compressed variant the file owns. With entry set, data is a
+// body borrowed from that response cache entry. While job is set it is a placeholder for
+// a response the compression pool is still working on, while handler is set one for a
+// response a handler worker is still making.
+typedef struct EvOutChunk {
+    char *data;
+    size_t len;
+    size_t off;
+    StaticFile *file;
+    off_t file_off;
+    ResponseCacheEntry *entry;
+    struct EvCompressJob *job;
+    struct EvHandlerJob *handler;
+    struct EvOutChunk *next;
+} EvOutChunk;
+
+typedef enum {
+    EvCompressResponse,  // a handler response, queued behind a placeholder chunk
+    EvCompressCached,    // a variant for a response cache entry
+    EvCompressStatic,    // a variant for an open static file
+} EvCompressKind;
+
+// a compression handed to the pool; everything but job belongs to the reactor thread
+typedef struct EvCompressJob {
+    CompressJob job;  // first, so a finished CompressJob leads back here
+    EvCompressKind kind;
+    EvOutChunk *chunk;  // the placeholder, NULL once its connection has dropped it
+    int fd;
+    int status;
+    int keep_alive;
+    char *content_type;
+    char *cache_control;
+    char *vary;
+    char *body;
+    int has_etag;
+    char etag[HTTP_ETAG_SIZE];
+    ResponseCacheEntry *entry;
+    StaticFile *file;
+} EvCompressJob;
+
+// an io_uring sendmsg in flight; the kernel reads the chunks until it completes
+typedef struct EvSendOp {
+    int fd;
+    struct msghdr msg;
+    struct iovec iov[WRITEV_BATCH];
+    EvOutChunk *orphans;  // output of a connection closed mid-send, freed on completion
+} EvSendOp;
+
+/*
+ * Per-connection state, indexed by fd. Bytes accumulate in buf across EPOLLIN
+ * events until the parser has a whole request; anything read past it stays buffered
+ * for the next one. Requests that fit are read into the embedded inline_buf, larger
+ * ones move to a pooled buffer, and an idle connection holds none. Responses queue in the output
+ * chain and drain on EPOLLOUT; reading pauses while more than OUTPUT_HIGH_WATER bytes
+ * are waiting, so a slow reader cannot make the server buffer without bound.
+ */
+typedef struct EvConn {
+    char *buf;
+    size_t len;
+    size_t capacity;
+    size_t scanned;     // bytes already searched for the end of the headers
+    size_t header_len;
+    size_t expected;    // header_len + Content-Length, known once the headers are in
+    EvParseState state;
+    HttpChunkedDecoder chunked;  // a chunked body decoded in place behind the headers
+    int reject_status;
+    EvOutChunk *out_head;
+    EvOutChunk *out_tail;
+    size_t out_bytes;     // queued and not yet written
+    uint32_t events;      // epoll mask currently registered, 0 when not in the set
+    unsigned generation;  // bumped on accept, so a queued request can tell its fd was reused
+    int open;
+    int dispatching;      // a request of this connection waits in the dispatch queue
+    int closing;          // close once the output queue drains
+    int readable;         // input may be waiting: set by EPOLLIN, cleared when a read hits EAGAIN
+    int ready;            // edge-triggered: queued to be read on the next loop iteration
+    int ready_next;
+    int recv_armed;       // io_uring: 1 while a recv is in flight, 2 once it is being cancelled
+    EvSendOp *send_op;    // io_uring: the send in flight, at most one so output stays ordered
+    int compressing;      // placeholder chunks waiting for the compression pool
+    int idle;             // in the reactor's idle list: nothing buffered, nothing queued
+    int idle_prev;
+    int idle_next;
+    int requests;         // requests parsed on this connection
+    int max_requests;     // the request that reaches this is answered with Connection: close
+    long long idle_ms;    // how long the client may stay quiet
+    long long last_active;
+    TimerEntry deadline;  // pending while the connection is open, checks last_active when it fires
+    // last, so closing a connection only clears the fields above it
+    char inline_buf[INLINE_BUFFER_SIZE];
+} EvConn;
+
+typedef struct EvReactor {
+    EvServer *server;
+    int index;
+    V8Engine *engine;
+    int server_fd;
+    int epoll_fd;
+    int timer_fd;
+    int max_events;      // epoll_wait batch, adapted to how many events arrive per wakeup
+    int accept_pending;  // the listening socket may still have connections queued
+    int ready_head;      // connections with unread input that no new edge will report
+    int ready_tail;
+    // idle keep-alive connections, least recently used first; evicted under fd pressure
+    int idle_head;
+    int idle_tail;
+    long long now;  // monotonic time of the current loop iteration
+    EvTimers *timers;
+    uint64_t timer_armed;  // deadline the timerfd is set for, UINT64_MAX when disarmed
+    // parsed requests wait here between reading and JS dispatch, one flow per client
+    FairQueue *dispatch_queue;
+    EvConn *conns;
+    int max_conns;
+    // io_uring backend; NULL when the reactor runs on epoll
+    Uring *ring;
+    UringBufRing recv_bufs;
+    int recv_single;  // the kernel has no multishot recv, arm one recv at a time
+    // recycled requests and output chunks, so serving a request needs no malloc once warm
+    struct EvPendingRequest *free_requests;
+    int free_request_count;
+    EvOutChunk *free_chunks;
+    int free_chunk_count;
+    StaticFileCache *static_cache;  // open files of ASP.serveStatic routes
+    // the compression pool hands finished jobs back here
+    JobCompletions compress_done;
+    int compress_inflight;
+    // so does the handler pool with the requests it ran
+    JobCompletions handler_done;
+    int handler_inflight;
+    // and the fs pool with the ASP.fs calls of the reactor's isolate
+    JobCompletions fs_done;
+    int fs_inflight;
+    TimerEntry date_tick;  // refreshes the Date line on every second
+    pthread_t thread;
+} EvReactor;
+
+struct EvServer {
+    V8Engine *engine;  // ran the app script at startup, reactor 0 keeps using it
+    int port;
+    int fair_by_peer;
+    const char *fair_header;
+    int fair_quantum;
+    int num_reactors;
+    int use_uring;
+    int edge_triggered;
+    int shared_fd;  // one listening socket for all reactors, or -1 for one each via SO_REUSEPORT
+    int keep_alive_timeout;  // seconds, 0 when keep-alive is off
+    int keep_alive_max;
+    int handler_window;  // bursts a reactor may have on the handler workers, 0 when handlers run on the reactors
+    EvReactor *reactors;
+};
+
+// smallest body worth compressing, 0 when compression is off; set before the reactors start
+static int compress_min_bytes = 0;
+
+// timer calls land in the reactor whose isolate is running on this thread
+static __thread EvReactor *current_reactor = NULL;
+// the app script runs before any reactor exists; reactor 0 adopts the timers it set
+static EvTimers startup_timers;
+static int startup_timers_ready = 0;
+
+// bump allocator for the strings of one request, reused by the next
+typedef struct EvArena {
+    char *data;
+    size_t capacity;
+    size_t used;
+} EvArena;
+
+// one parsed request; a pipelined burst is queued as a chain in arrival order
+typedef struct EvPendingRequest {
+    EvHttpRequest request;
+    int keep_alive;
+    unsigned generation;
+    EvArena arena;  // method, path, headers and body point into it
+    struct EvPendingRequest *next;
+} EvPendingRequest;
+
+// a request handed to a handler worker; the worker fills in the result, the rest belongs to the reactor thread
+typedef struct EvHandlerJob {
+    PoolJob job;     // first, so a finished PoolJob leads back here
+    int respond;     // 0 when the handler only refreshes the response cache
+    EvOutChunk *chunk;  // the placeholder, NULL once its connection has dropped it
+    int fd;
+    EvPendingRequest *pending;  // the request, followed by the rest of its burst
+    HttpResponse response;
+    struct EvCompressJob *deferred;
+} EvHandlerJob;
+
+/* Whether a chunk still waits for its response; output stops in front of it. */
+static int chunk_waiting(const EvOutChunk *chunk) {
+    return chunk->job || chunk->handler;
+}
+
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Timer table setup and teardown. Destroying releases the   *
+  * JS callbacks only if their isolate is still alive.        *
+  *************************************************************
+*/
+static void ev_timers_init(EvTimers *timers) {
+    memset(timers, 0, sizeof(*timers));
+    timer_wheel_init(&timers->wheel, monotonic_ms());
+}
+
+static void ev_timers_destroy(EvTimers *timers, int release_callbacks) {
+    for (unsigned slot = 0; slot < timers->used; slot++) {
+        EvJsTimer *timer = timers->slots[slot].timer;
+        if (!timer) continue;
+        timer_wheel_cancel(&timers->wheel, &timer->entry);
+        if (release_callbacks) v8_free_object(timer->callback);
+        free(timer);
+    }
+    free(timers->slots);
+    timers->slots = NULL;
+    timers->capacity = timers->used = timers->free_head = 0;
+}
+
+static EvTimers *ev_timers_get(EvReactor *r) {
+    if (r) return r->timers;
+    if (!startup_timers_ready) {
+        ev_timers_init(&startup_timers);
+        startup_timers_ready = 1;
+    }
+    return &startup_timers;
+}
 
 /**
  *   __  __
@@ -66,23 +408,210 @@ static int interval_ms = 1000;
  *  |_|  |_| M4
  *
  * Sets or updates the interval timer for the event-based server using a timer file descriptor.
+ * The timerfd is one-shot, set to the absolute time of the wheel's next deadline, and only
+ * rewritten when that deadline moves.
  *
  * APIs and system calls used:
  *   - `timerfd_settime`: Linux system call to set the expiration interval of a timer file descriptor.
  *   - `struct itimerspec`: POSIX structure to specify timer intervals and initial expiration.
  */
-void initialize_timer(int ms) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void initialize_timer(EvReactor *r) {
+    // timers may be set before the reactor is set up; setup_timer_fd() arms it then
+    if (r->timer_fd == -1) return;
+    uint64_t deadline = timer_wheel_next_deadline(&r->timers->wheel);
+    if (deadline == r->timer_armed) return;
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (deadline != UINT64_MAX) {
+        spec.it_value.tv_sec = deadline / 1000;
+        spec.it_value.tv_nsec = (long)(deadline % 1000) * 1000000L;
+    }
+    if (timerfd_settime(r->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        perror("timerfd_settime");
+        return;
+    }
+    r->timer_armed = deadline;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Runs a JS timer's callback, then schedules its next run   *
+  * or releases it. An interval keeps its period, unless it   *
+  * has fallen a whole period behind.                         *
+  *************************************************************
+*/
+static void js_timer_release(EvTimers *timers, EvJsTimer *timer) {
+    EvJsTimerSlot *slot = &timers->slots[timer->slot];
+    slot->timer = NULL;
+    slot->generation++;
+    slot->next_free = timers->free_head;
+    timers->free_head = timer->slot + 1;
+    v8_free_object(timer->callback);
+    free(timer);
+}
+
+static void js_timer_fire(TimerEntry *entry, void *arg) {
+    EvTimers *timers = arg;
+    EvJsTimer *timer = (EvJsTimer *)entry;
+    EvReactor *r = current_reactor;
+    timer->firing = 1;
+    JSResult res = v8_call_function_no_arguments(r->engine, timer->callback);
+    if (res.type == JS_STRING) free(res.value.str_result);
+    else if (res.type == JS_OBJECT) v8_free_object(res.value.obj_result);
+    timer->firing = 0;
+    if (timer->cleared || !timer->interval_ms) {
+        js_timer_release(timers, timer);
+        return;
+    }
+    uint64_t now = monotonic_ms();
+    uint64_t next = entry->expires + timer->interval_ms;
+    timer_wheel_add(&timers->wheel, entry, next > now ? next : now + timer->interval_ms);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Called from SetIntervalImpl and SetTimeoutImpl to         *
+  * register the callback provided to V8, on the reactor      *
+  * that owns the isolate. Returns the timer id, or -1.       *
+  * Handler workers have no loop to run timers on: theirs are *
+  * dropped and get id 0, which clearing ignores.             *
+  *************************************************************
+*/
+long long register_js_timer(int ms, int repeat, JSObject cb) {
+    if (isolate_pool_on_worker()) {
+        v8_free_object(cb);
+        return 0;
+    }
+    EvReactor *r = current_reactor;
+    EvTimers *timers = ev_timers_get(r);
+    unsigned slot;
+    if (timers->free_head) {
+        slot = timers->free_head - 1;
+        timers->free_head = timers->slots[slot].next_free;
+    } else {
+        if (timers->used == timers->capacity) {
+            unsigned capacity = timers->capacity ? timers->capacity * 2 : 64;
+            if (capacity > (1u << JS_TIMER_SLOT_BITS)) return -1;
+            EvJsTimerSlot *slots = realloc(timers->slots, capacity * sizeof(EvJsTimerSlot));
+            if (!slots) return -1;
+            timers->slots = slots;
+            timers->capacity = capacity;
+        }
+        slot = timers->used++;
+        // ids start at generation 1 so none of them is 0
+        timers->slots[slot] = (EvJsTimerSlot){ .generation = 1 };
+    }
+    EvJsTimer *timer = calloc(1, sizeof(EvJsTimer));
+    if (!timer) {
+        timers->slots[slot].next_free = timers->free_head;
+        timers->free_head = slot + 1;
+        return -1;
+    }
+    if (ms < 1) ms = 1;
+    timer->callback = cb;
+    timer->interval_ms = repeat ? ms : 0;
+    timer->slot = slot;
+    timers->slots[slot].timer = timer;
+    timer_entry_init(&timer->entry, js_timer_fire, timers);
+    timer_wheel_add(&timers->wheel, &timer->entry, monotonic_ms() + ms);
+    if (r) initialize_timer(r);
+    return ((long long)timers->slots[slot].generation << JS_TIMER_SLOT_BITS) | slot;
+}
+
+/* clearInterval and clearTimeout. Unknown or stale ids are ignored. */
+void clear_js_timer(long long id) {
+    if (isolate_pool_on_worker()) return;
+    EvReactor *r = current_reactor;
+    EvTimers *timers = ev_timers_get(r);
+    if (id <= 0) return;
+    unsigned slot = id & ((1u << JS_TIMER_SLOT_BITS) - 1);
+    if (slot >= timers->used) return;
+    EvJsTimer *timer = timers->slots[slot].timer;
+    if (!timer || timers->slots[slot].generation != (unsigned)(id >> JS_TIMER_SLOT_BITS)) return;
+    if (timer->firing) {
+        timer->cleared = 1;
+        return;
+    }
+    timer_wheel_cancel(&timers->wheel, &timer->entry);
+    js_timer_release(timers, timer);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Called from the ASP.fs functions to run a file call off   *
+  * the loop. The job comes back to the reactor that owns the *
+  * calling isolate. -1 when there is no such reactor (the    *
+  * app script at startup, handler workers) or no fs pool;    *
+  * the caller then runs the job itself.                      *
+  *************************************************************
+*/
+int submit_js_fs_job(FsJob *job) {
+    EvReactor *r = current_reactor;
+    if (isolate_pool_on_worker() || !r || r->fs_done.event_fd < 0) return -1;
+    if (fs_submit(job, &r->fs_done) < 0) return -1;
+    r->fs_inflight++;
+    return 0;
+}
+
+/* Settles the Promises of finished fs calls; once the server is stopping they are only freed. */
+static void handle_fs_event(EvReactor *r) {
+    FsJob *done = (FsJob *)job_completions_take(&r->fs_done);
+    while (done) {
+        FsJob *next = (FsJob *)done->job.next;
+        r->fs_inflight--;
+        if (server_running_eb) v8_settle_fs_job(r->engine, done);
+        v8_free_object(done->resolver);
+        fs_job_free(done);
+        done = next;
+    }
+}
+
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  *************************************************************
+*/
+static void cleanup_request(EvHttpRequest *request) {
+    for (size_t i = 0; i < request->header_count; i++) {
+        free(request->headers[i].name);
+        free(request->headers[i].value);
+    }
+
+    free(request->method);
+    free(request->path);
+    free(request->body);
 }
 
 /*
@@ -95,16 +624,31 @@ void initialize_timer(int ms) {
   *   ██║  ██║███████║██║                                     *
   *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
   *                                                           *
-  * Called from SetIntervalImpl to register the callback      *
-  * provided to V8                                            *
+  * strndup into the arena, or onto the heap without one.     *
+  * The arena is sized up front by the caller, so it never    *
+  * runs out.                                                 *
   *************************************************************
 */
-void register_js_interval_callback(int ms, JSObject cb) {
-    interval_callback = cb;
-    interval_ms = ms;
-    initialize_timer(ms);
+static char *arena_strndup(EvArena *arena, const char *s, size_t n) {
+    if (!arena) return strndup(s, n);
+    if (arena->used + n + 1 > arena->capacity) return NULL;
+    char *copy = arena->data + arena->used;
+    memcpy(copy, s, n);
+    copy[n] = '\0';
+    arena->used += n + 1;
+    return copy;
 }
 
+static int arena_reserve(EvArena *arena, size_t need) {
+    arena->used = 0;
+    if (need <= arena->capacity) return 1;
+    char *data = malloc(need);
+    if (!data) return 0;
+    free(arena->data);
+    arena->data = data;
+    arena->capacity = need;
+    return 1;
+}
 
 /**
  *   __  __
@@ -125,23 +669,242 @@ void register_js_interval_callback(int ms, JSObject cb) {
  *   5. Ensure all allocated memory is freed in case of errors.
  *   6. The function should be robust against malformed requests.
  *   7. The function should handle requests with no/invalid headers, no body (etc.) gracefully.
+ *   A chunked body has already been decoded in place by the connection's parser.
  *
  * Useful APIs and system calls that you may need:
  *   - Memory management: malloc(), free()
  *   - String manipulation and parsing: sscanf(), strstr(), strncpy(), strlen(), strtol(), etc
  */
+static void parse_request(const char *raw_request, EvHttpRequest *request, EvArena *arena);
+
 void parse_http_request_with_header(const char *raw_request, EvHttpRequest *request) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    parse_request(raw_request, request, NULL);
+}
+
+/* The parser behind parse_http_request_with_header; with an arena the strings are not freed one by one. */
+static void parse_request(const char *raw_request, EvHttpRequest *request, EvArena *arena) {
+    memset(request, 0, sizeof(*request));
+    const char *line_end = strchr(raw_request, '\n');
+    if (!line_end) return;
+    const char *method_end = memchr(raw_request, ' ', line_end - raw_request);
+    if (!method_end || method_end == raw_request) return;
+    const char *path = method_end + 1;
+    const char *path_end = memchr(path, ' ', line_end - path);
+    if (!path_end) path_end = line_end;
+    while (path_end > path && (path_end[-1] == '\r' || path_end[-1] == ' ')) path_end--;
+    if (path_end == path) return;
+    request->method = arena_strndup(arena, raw_request, method_end - raw_request);
+    request->path = arena_strndup(arena, path, path_end - path);
+    if (!request->method || !request->path) {
+        if (!arena) cleanup_request(request);
+        memset(request, 0, sizeof(*request));
+        return;
+    }
+
+    long content_length = 0;
+    const char *p = line_end + 1;
+    while (*p && *p != '\r' && *p != '\n') {
+        const char *eol = strchr(p, '\n');
+        // a header line without its terminator has not fully arrived
+        if (!eol) break;
+        const char *colon = memchr(p, ':', eol - p);
+        if (colon && request->header_count < MAX_HEADERS) {
+            const char *value = colon + 1;
+            while (value < eol && (*value == ' ' || *value == '\t')) value++;
+            const char *value_end = eol;
+            while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ')) value_end--;
+            EvHttpHeader *header = &request->headers[request->header_count];
+            header->name = arena_strndup(arena, p, colon - p);
+            header->value = arena_strndup(arena, value, value_end - value);
+            if (!header->name || !header->value) {
+                if (!arena) free(header->name);
+                if (!arena) free(header->value);
+            } else {
+                request->header_count++;
+                if (strcasecmp(header->name, "Content-Length") == 0) {
+                    content_length = strtol(header->value, NULL, 10);
+                }
+            }
+        }
+        p = eol + 1;
+    }
+    if (*p == '\r') p++;
+    if (*p != '\n') return;
+    p++;
+    size_t available = strlen(p);
+    size_t body_len = content_length > 0 && (size_t)content_length < available ? (size_t)content_length : available;
+    if (body_len == 0) return;
+    request->body = arena_strndup(arena, p, body_len);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Builds the JS request object: method, path, body, size    *
+  * and a headers object keyed by header name.                *
+  *************************************************************
+*/
+static JSObject create_js_request_object_eb(V8Engine *engine, const EvHttpRequest *request) {
+    JSObject req_obj = v8_create_object(engine);
+    if (!req_obj) return NULL;
+    JSObject headers = v8_create_object(engine);
+    int ok = headers != NULL &&
+             v8_set_string_property(engine, req_obj, "method", request->method) &&
+             v8_set_string_property(engine, req_obj, "path", request->path) &&
+             v8_set_number_property(engine, req_obj, "size", request->body ? (long)strlen(request->body) : 0);
+    if (ok && request->body) ok = v8_set_string_property(engine, req_obj, "body", request->body);
+    for (int i = 0; ok && i < request->header_count; i++) {
+        ok = v8_set_string_property(engine, headers, request->headers[i].name, request->headers[i].value);
+    }
+    if (ok) ok = v8_set_object_property(engine, req_obj, "headers", headers);
+    if (headers) v8_free_object(headers);
+    if (!ok) {
+        v8_free_object(req_obj);
+        return NULL;
+    }
+    return req_obj;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Formats the header block of a handler response, the lines *
+  * that follow the status line and Date. A 304 carries only  *
+  * the validators. The caller attaches the body.             *
+  *************************************************************
+*/
+typedef struct EvResponseMeta {
+    int status;
+    const char *content_type;
+    const char *cache_control;  // passed through from the handler
+    const char *vary;           // the handler's, merged with Accept-Encoding when that applies too
+    const char *etag;
+    HttpEncoding encoding;      // of the body
+    int vary_encoding;          // the body depends on Accept-Encoding
+    long long age;              // Age of a cached copy, -1 for a response just made
+} EvResponseMeta;
+
+/* Appends "name: value more\r\n" at out + *len, or only counts it while out is NULL. */
+static void append_header(char *out, size_t *len, const char *name, const char *value, const char *more) {
+    const char *parts[] = { name, ": ", value, more, "\r\n" };
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        size_t part_len = strlen(parts[i]);
+        if (out) memcpy(out + *len, parts[i], part_len);
+        *len += part_len;
+    }
+}
+
+/* The optional lines of a handler response, written to out unless it is NULL. Returns their length. */
+static size_t format_response_extra(const EvResponseMeta *meta, char *out) {
+    size_t len = 0;
+    if (meta->encoding != HTTP_ENCODING_IDENTITY) {
+        append_header(out, &len, "Content-Encoding", http_encoding_name(meta->encoding), "");
+    }
+    if (meta->vary && *meta->vary) {
+        // Vary: * already covers every header
+        int add_encoding = meta->vary_encoding && !strchr(meta->vary, '*') && !strcasestr(meta->vary, "Accept-Encoding");
+        append_header(out, &len, "Vary", meta->vary, add_encoding ? ", Accept-Encoding" : "");
+    } else if (meta->vary_encoding) {
+        append_header(out, &len, "Vary", "Accept-Encoding", "");
+    }
+    if (meta->etag) append_header(out, &len, "ETag", meta->etag, "");
+    if (meta->cache_control) append_header(out, &len, "Cache-Control", meta->cache_control, "");
+    if (meta->age >= 0) {
+        char age[24];
+        snprintf(age, sizeof(age), "%lld", meta->age);
+        append_header(out, &len, "Age", age, "");
+    }
+    if (out) out[len] = '\0';
+    return len;
+}
+
+static void format_response(const EvResponseMeta *meta, size_t body_len, int keep_alive, HttpResponse *response) {
+    *response = (HttpResponse){ .status = meta->status };
+    char *extra = malloc(format_response_extra(meta, NULL) + 1);
+    if (!extra) return;
+    format_response_extra(meta, extra);
+    const char *conn = keep_alive ? "keep-alive" : "close";
+    char *out;
+    int len;
+    if (meta->status == 304) {
+        const char *format =
+            "%s"
+            "Server: asp-v8/1.0\r\n"
+            "Connection: %s\r\n"
+            "\r\n";
+        len = snprintf(NULL, 0, format, extra, conn);
+        out = malloc(len + 1);
+        if (out) snprintf(out, len + 1, format, extra, conn);
+    } else {
+        const char *format =
+            "Content-Type: %s\r\n"
+            "Content-Length: %zu\r\n"
+            "%s"
+            "Server: asp-v8/1.0\r\n"
+            "Connection: %s\r\n"
+            "\r\n";
+        const char *type = meta->content_type ? meta->content_type : "text/plain";
+        len = snprintf(NULL, 0, format, type, body_len, extra, conn);
+        out = malloc(len + 1);
+        if (out) snprintf(out, len + 1, format, type, body_len, extra, conn);
+    }
+    free(extra);
+    if (!out) return;
+    response->headers = out;
+    response->headers_len = len;
+}
+
+/* Header lookup for the response cache's Vary matching. */
+static const char *request_header(const void *data, const char *name) {
+    const EvHttpRequest *request = data;
+    for (int i = 0; i < request->header_count; i++) {
+        if (strcasecmp(request->headers[i].name, name) == 0) return request->headers[i].value;
+    }
+    return NULL;
+}
+
+/* Whether the client's copy, named in If-None-Match, is still the current one. */
+static int request_not_modified(const EvHttpRequest *request, const char *etag) {
+    const char *if_none_match = etag ? request_header(request, "If-None-Match") : NULL;
+    return if_none_match && http_etag_matches(if_none_match, strlen(if_none_match), etag);
+}
+
+/*
+ * The coding to send a body in. vary is set when the choice depended on Accept-Encoding,
+ * that is for compressible bodies of at least ASP_COMPRESS_MIN_BYTES. HEAD is never
+ * compressed.
+ */
+static HttpEncoding response_encoding(const EvHttpRequest *request, const char *content_type, size_t body_len, int *vary) {
+    *vary = compress_min_bytes > 0 && body_len >= (size_t)compress_min_bytes && http_compressible_type(content_type);
+    if (!*vary || strcmp(request->method, "HEAD") == 0) return HTTP_ENCODING_IDENTITY;
+    return http_negotiate_encoding(request_header(request, "Accept-Encoding"));
+}
+
+/* A compressed variant is a different representation, so it gets a tag of its own. */
+static void variant_etag(const char *etag, HttpEncoding encoding, char *out, size_t out_size) {
+    if (encoding == HTTP_ENCODING_IDENTITY) snprintf(out, out_size, "%s", etag);
+    else snprintf(out, out_size, "%.*s-%s\"", (int)strlen(etag) - 1, etag, http_encoding_name(encoding));
+}
+
+/* GET and HEAD may be answered from the response cache, unless they carry credentials. */
+static int request_cacheable(const EvHttpRequest *request) {
+    if (!response_cache_enabled() || !request->method || !request->path) return 0;
+    if (strcmp(request->method, "GET") != 0 && strcmp(request->method, "HEAD") != 0) return 0;
+    return request_header(request, "Host") && !request_header(request, "Authorization");
 }
 
 /**
@@ -166,6 +929,13 @@ void parse_http_request_with_header(const char *raw_request, EvHttpRequest *requ
  *   6. Handle keep-alive settings in the "Connection" header.
  *   7. Ensure proper error handling and default values.
  *
+ * A GET or HEAD response whose Cache-Control allows it is stored in the response cache.
+ * A 200 to GET or HEAD carries a strong ETag of its body, and becomes a 304 when the
+ * client's If-None-Match already names it.
+ * Compressible bodies are sent gzip- or deflate-encoded when the client accepts it. Large
+ * ones are handed back in *deferred for the compression pool instead of being serialized.
+ * With response NULL the handler only refreshes the response cache.
+ *
  * Useful APIs and system calls that you may need:
  *   - v8_create_object: to create a new JS object.
  *   - v8_set_string_property: to set properties on the JS object.
@@ -173,21 +943,140 @@ void parse_http_request_with_header(const char *raw_request, EvHttpRequest *requ
  *   - v8_call_registered_handler_obj: to call the handler with the request object.
  *   - v8_get_number_property: to retrieve numeric properties from the response object.
  */
-static void handle_request(V8Engine *engine, const EvHttpRequest *request, char **response_buffer, size_t *response_size, int keep_alive) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void handle_request(V8Engine *engine, const EvHttpRequest *request, HttpResponse *response, int keep_alive,
+                           EvCompressJob **deferred) {
+    if (response) {
+        *response = (HttpResponse){ 0 };
+        *deferred = NULL;
+    }
+    int status = 500;
+    char *content_type = NULL;
+    char *cache_control = NULL;
+    char *vary = NULL;
+    char *body = NULL;
+    JSObject req_obj = create_js_request_object_eb(engine, request);
+    if (req_obj && v8_get_registered_handler_func(engine)) {
+        JSResult res = v8_call_registered_handler_obj(engine, req_obj);
+        if (res.success && res.type == JS_OBJECT && res.value.obj_result) {
+            JSObject res_obj = res.value.obj_result;
+            int ok = 0;
+            int js_status = v8_get_number_property(engine, res_obj, "status", &ok);
+            status = ok ? js_status : 200;
+            JSObject headers = v8_get_object_property(engine, res_obj, "headers");
+            if (headers) {
+                content_type = (char *)v8_get_string_property(engine, headers, "Content-Type");
+                cache_control = (char *)v8_get_string_property(engine, headers, "Cache-Control");
+                vary = (char *)v8_get_string_property(engine, headers, "Vary");
+                v8_free_object(headers);
+            }
+            body = (char *)v8_get_string_property(engine, res_obj, "body");
+            v8_free_object(res_obj);
+        } else if (res.type == JS_STRING) {
+            free(res.value.str_result);
+        }
+    }
+    if (req_obj) v8_free_object(req_obj);
+
+    if (!body && status >= 400) body = strdup(http_status_text(status));
+    const char *body_text = body ? body : "";
+    size_t body_len = strlen(body_text);
+    int is_head = strcmp(request->method, "HEAD") == 0;
+    char etag[HTTP_ETAG_SIZE];
+    int has_etag = status == 200 && (is_head || strcmp(request->method, "GET") == 0);
+    if (has_etag) http_etag(body_text, body_len, etag, sizeof(etag));
+    ResponseCacheEntry *entry = NULL;
+    // also called for responses that may not be cached, to drop what they replace
+    if (request_cacheable(request)) {
+        entry = response_cache_store(request->method, request->path, request_header, request, monotonic_ms(), status,
+                                     content_type, body_text, body_len, cache_control, vary, has_etag ? etag : NULL);
+    }
+    // a refresh of the cache only
+    if (!response) goto done;
+
+    EvResponseMeta meta = { status, content_type, cache_control, vary, has_etag ? etag : NULL, HTTP_ENCODING_IDENTITY, 0,
+                            -1 };
+    HttpEncoding encoding = response_encoding(request, content_type, body_len, &meta.vary_encoding);
+    char variant[VARIANT_ETAG_SIZE];
+    if (has_etag) variant_etag(etag, encoding, variant, sizeof(variant));
+    if (has_etag && request_not_modified(request, variant)) {
+        // the client has this very variant, so there is nothing to compress
+        meta.status = 304;
+        meta.etag = variant;
+        format_response(&meta, 0, keep_alive, response);
+    } else if (encoding != HTTP_ENCODING_IDENTITY && body_len >= COMPRESS_OFFLOAD_BYTES) {
+        EvCompressJob *job = calloc(1, sizeof(EvCompressJob));
+        if (job) {
+            // the job takes over the body, the strings and the cache reference
+            *job = (EvCompressJob){ .job = { .encoding = encoding, .input = body, .input_len = body_len, .input_fd = -1 },
+                                    .kind = EvCompressResponse, .status = status, .keep_alive = keep_alive,
+                                    .content_type = content_type, .cache_control = cache_control, .vary = vary,
+                                    .body = body,
+                                    .has_etag = has_etag, .entry = entry };
+            if (has_etag) memcpy(job->etag, etag, sizeof(etag));
+            if (entry && !response_cache_claim_encoding(entry, encoding)) job->entry = NULL;
+            else entry = NULL;
+            content_type = cache_control = vary = body = NULL;
+            *deferred = job;
+        }
+    } else if (encoding != HTTP_ENCODING_IDENTITY) {
+        char *encoded = NULL;
+        size_t encoded_len = 0;
+        int ok = http_compress(encoding, body_text, body_len, &encoded, &encoded_len) == 0;
+        if (entry && response_cache_claim_encoding(entry, encoding)) {
+            response_cache_attach_encoded(entry, encoding, encoded, encoded_len);
+        }
+        if (ok) {
+            meta.encoding = encoding;
+            meta.etag = has_etag ? variant : NULL;
+            format_response(&meta, encoded_len, keep_alive, response);
+            response->body = encoded;
+            response->body_len = encoded_len;
+        } else {
+            format_response(&meta, body_len, keep_alive, response);
+            response->body = body;
+            response->body_len = body_len;
+            body = NULL;
+        }
+    } else {
+        format_response(&meta, body_len, keep_alive, response);
+        // the handler's string goes out as it is
+        if (!is_head) {
+            response->body = body;
+            response->body_len = body_len;
+            body = NULL;
+        }
+    }
+    if (meta.status == 200) telemetry_increment_200_responses();
+done:
+    if (entry) response_cache_release(entry);
+    free(content_type);
+    free(cache_control);
+    free(vary);
+    free(body);
 }
 
 
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Case-insensitive substring search in a header value       *
+  *************************************************************
+*/
+static const char *find_token(const char *value, const char *token) {
+    size_t token_len = strlen(token);
+    for (; *value; value++) {
+        if (strncasecmp(value, token, token_len) == 0) return value;
+    }
+    return NULL;
+}
+
 /**
  *   __  __
  *  |  \/  |
@@ -205,21 +1094,59 @@ static void handle_request(V8Engine *engine, const EvHttpRequest *request, char
  *   4. Parse the keep-alive header for timeout and max values if present.
  *   5. Handle errors and malformed headers gracefully.
  *
+ * The returned strings are copied into the arena, or onto the heap if it is NULL.
+ *
  * APIs and system calls that you may want to use:
  * - String manipulation functions: strtok(), strncasecmp(), atoi()
  */
-static void parse_keep_alive_headers(const char *buffer, char **http_version, char **connection_hdr, char **keep_alive_hdr, int *keep_alive, int *keep_alive_timeout, int *keep_alive_max) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void parse_keep_alive_headers(const char *buffer, EvArena *arena, char **http_version, char **connection_hdr, char **keep_alive_hdr, int *keep_alive, int *keep_alive_timeout, int *keep_alive_max) {
+    *http_version = NULL;
+    *connection_hdr = NULL;
+    *keep_alive_hdr = NULL;
+    *keep_alive = 0;
+    *keep_alive_timeout = DEFAULT_KEEP_ALIVE_TIMEOUT;
+    *keep_alive_max = DEFAULT_KEEP_ALIVE_MAX;
+
+    const char *line_end = strchr(buffer, '\n');
+    if (!line_end) return;
+    // the version is the last token of the request line
+    const char *version_end = line_end;
+    while (version_end > buffer && (version_end[-1] == '\r' || version_end[-1] == ' ')) version_end--;
+    const char *version = version_end;
+    while (version > buffer && version[-1] != ' ') version--;
+    *http_version = arena_strndup(arena, version, version_end - version);
+    *keep_alive = *http_version && strcmp(*http_version, "HTTP/1.1") == 0;
+
+    const char *p = line_end + 1;
+    while (*p && *p != '\r' && *p != '\n') {
+        const char *eol = strchr(p, '\n');
+        if (!eol) break;
+        const char *colon = memchr(p, ':', eol - p);
+        if (colon) {
+            const char *value = colon + 1;
+            while (value < eol && (*value == ' ' || *value == '\t')) value++;
+            const char *value_end = eol;
+            while (value_end > value && (value_end[-1] == '\r' || value_end[-1] == ' ')) value_end--;
+            size_t name_len = colon - p;
+            if (name_len == 10 && strncasecmp(p, "Connection", 10) == 0 && !*connection_hdr) {
+                *connection_hdr = arena_strndup(arena, value, value_end - value);
+            } else if (name_len == 10 && strncasecmp(p, "Keep-Alive", 10) == 0 && !*keep_alive_hdr) {
+                *keep_alive_hdr = arena_strndup(arena, value, value_end - value);
+            }
+        }
+        p = eol + 1;
+    }
+
+    if (*connection_hdr) {
+        if (find_token(*connection_hdr, "close")) *keep_alive = 0;
+        else if (find_token(*connection_hdr, "keep-alive")) *keep_alive = 1;
+    }
+    if (*keep_alive_hdr) {
+        const char *timeout = find_token(*keep_alive_hdr, "timeout=");
+        const char *max = find_token(*keep_alive_hdr, "max=");
+        if (timeout && atoi(timeout + 8) > 0) *keep_alive_timeout = atoi(timeout + 8);
+        if (max && atoi(max + 4) > 0) *keep_alive_max = atoi(max + 4);
+    }
 }
 
 
@@ -232,6 +1159,9 @@ static void parse_keep_alive_headers(const char *buffer, char **http_version, ch
  *  |_|  |_| M4
  *
  * Handles timer events by reading the timer file descriptor and calling the interval callback.
+ * The timerfd is armed for the wheel's next deadline. Turning the wheel runs every timer
+ * that is due, JS callbacks and internal deadlines alike, and then the timerfd is armed
+ * for the next deadline.
  *
  * Implementation hints:
  *  1. Read the number of expirations from the timer file descriptor.
@@ -240,55 +1170,1182 @@ static void parse_keep_alive_headers(const char *buffer, char **http_version, ch
  * APIs and system calls used:
  *   - `v8_call_function_no_arguments`: to call the JavaScript function registered as the interval callback.
  */
-static void handle_timer_event(V8Engine *engine) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-}
-
-/**
- *   __  __
- *  |  \/  |
- *  | \  / |
- *  | |\/| |
- *  | |  | |
- *  |_|  |_| M4
- *
- * Accepts a new client connection and adds it to the epoll instance.
- *
- * Implementation hints:
- *   1. Accept a new client connection on the server socket.
- *   2. Set the client socket to non-blocking mode.
- *   3. Initialize an epoll event structure for the client socket.
- *   4. Add the client socket to the epoll instance.
- *   5. Handle errors appropriately, ensuring resources are cleaned up if any step fails.
- *   6. Ensure the server can handle multiple simultaneous connections efficiently.
- *   7. Consider edge cases, such as reaching the maximum number of file descriptors.
- *
- * APIs and system calls that you may need:
- * - Socket operations: accept(), fcntl()
- * - Epoll operations: epoll_ctl()
- */
-static void handle_new_connection(int server_fd, int epoll_fd, struct epoll_event *ev) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void handle_timer_event(EvReactor *r) {
+    uint64_t expirations;
+    // a wakeup that finds the timer not yet expired still turns the wheel, harmlessly
+    if (read(r->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) perror("read timerfd");
+    r->timer_armed = UINT64_MAX;
+    r->now = monotonic_ms();
+    timer_wheel_advance(&r->timers->wheel, r->now);
+    initialize_timer(r);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Keeps the idle list in step with the connection: it is    *
+  * idle with no input buffered, no output queued and no      *
+  * request in flight, and joins at the most recent end.      *
+  *************************************************************
+*/
+static void conn_idle_update(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    int idle = c->open && !c->dispatching && !c->closing && !c->len && !c->out_bytes && !c->send_op && !c->compressing;
+    if (idle == c->idle) return;
+    c->idle = idle;
+    if (idle) {
+        c->idle_prev = r->idle_tail;
+        c->idle_next = -1;
+        if (r->idle_tail >= 0) r->conns[r->idle_tail].idle_next = fd;
+        else r->idle_head = fd;
+        r->idle_tail = fd;
+        return;
+    }
+    if (c->idle_prev >= 0) r->conns[c->idle_prev].idle_next = c->idle_next;
+    else r->idle_head = c->idle_next;
+    if (c->idle_next >= 0) r->conns[c->idle_next].idle_prev = c->idle_prev;
+    else r->idle_tail = c->idle_prev;
+}
+
+static void close_client(EvReactor *r, int fd);
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Closes the least recently used idle connection to free    *
+  * its fd. Returns 0 if there was none.                      *
+  *************************************************************
+*/
+static int evict_idle(EvReactor *r) {
+    int fd = r->idle_head;
+    if (fd < 0) return 0;
+    telemetry_increment_evictions();
+    close_client(r, fd);
+    return 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Connection deadline. Activity only stamps last_active;    *
+  * the timer checks it when it fires and moves itself to     *
+  * the new deadline, so busy connections never touch the     *
+  * wheel. A request being dispatched or compressed does not  *
+  * count as the client being quiet.                          *
+  *************************************************************
+*/
+static void conn_deadline_expired(TimerEntry *timer, void *arg) {
+    EvReactor *r = arg;
+    EvConn *c = (EvConn *)((char *)timer - offsetof(EvConn, deadline));
+    int fd = (int)(c - r->conns);
+    long long due = c->dispatching || c->compressing ? r->now + c->idle_ms : c->last_active + c->idle_ms;
+    if (due > r->now) {
+        timer_wheel_add(&r->timers->wheel, timer, due);
+        return;
+    }
+    telemetry_increment_idle_timeouts();
+    close_client(r, fd);
+}
+
+/* Reformats this thread's Date line just after each second begins, so responses only copy it. */
+static void date_tick(TimerEntry *timer, void *arg) {
+    EvReactor *r = arg;
+    http_date_refresh();
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    timer_wheel_add(&r->timers->wheel, timer, r->now + 1001 - ts.tv_nsec / 1000000);
+}
+
+static void conn_open(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    const EvServer *server = r->server;
+    // with keep-alive off the first request still gets the usual time to arrive
+    int timeout = server->keep_alive_timeout > 0 ? server->keep_alive_timeout : DEFAULT_KEEP_ALIVE_TIMEOUT;
+    c->idle_ms = (long long)timeout * 1000;
+    c->max_requests = server->keep_alive_max;
+    c->last_active = r->now;
+    timer_entry_init(&c->deadline, conn_deadline_expired, r);
+    timer_wheel_add(&r->timers->wheel, &c->deadline, r->now + c->idle_ms);
+    // the kernel hands out the lowest free fd, so a high one means the process is running out
+    if (fd >= r->max_conns - FD_PRESSURE_RESERVE) evict_idle(r);
+    conn_idle_update(r, fd);
+}
+
+/**
+ *   __  __
+ *  |  \/  |
+ *  | \  / |
+ *  | |\/| |
+ *  | |  | |
+ *  |_|  |_| M4
+ *
+ * Accepts a new client connection and adds it to the epoll instance.
+ * Takes up to ACCEPT_BUDGET connections per call. If the budget runs out, accept_pending
+ * brings the loop back for the rest: an edge-triggered listener will not report them again.
+ * When fds run short, the connection that has been idle longest is evicted to make room.
+ *
+ * Implementation hints:
+ *   1. Accept a new client connection on the server socket.
+ *   2. Set the client socket to non-blocking mode.
+ *   3. Initialize an epoll event structure for the client socket.
+ *   4. Add the client socket to the epoll instance.
+ *   5. Handle errors appropriately, ensuring resources are cleaned up if any step fails.
+ *   6. Ensure the server can handle multiple simultaneous connections efficiently.
+ *   7. Consider edge cases, such as reaching the maximum number of file descriptors.
+ *
+ * APIs and system calls that you may need:
+ * - Socket operations: accept(), fcntl()
+ * - Epoll operations: epoll_ctl()
+ */
+static void conn_update_events(EvReactor *r, int fd);
+
+static void handle_new_connection(EvReactor *r) {
+    r->accept_pending = 0;
+    for (int accepted = 0; accepted < ACCEPT_BUDGET; accepted++) {
+        int client_fd = accept4(r->server_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // out of fds: make room by closing the connection that has been idle longest
+            if ((errno == EMFILE || errno == ENFILE) && evict_idle(r)) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept4");
+            return;
+        }
+        // the connection table is sized to the fd limit, so this only trips if it was raised later
+        if (client_fd >= r->max_conns) {
+            close(client_fd);
+            continue;
+        }
+        socket_tune_accepted(client_fd);
+        EvConn *c = &r->conns[client_fd];
+        c->open = 1;
+        c->generation++;
+        conn_update_events(r, client_fd);
+        if (!c->events) {
+            close(client_fd);
+            c->open = 0;
+            continue;
+        }
+        conn_open(r, client_fd);
+    }
+    r->accept_pending = 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Registers the events the connection currently needs:      *
+  * EPOLLIN unless its request is being dispatched, it is     *
+  * closing or its output is over the high-water mark, and    *
+  * EPOLLOUT while output is queued.                          *
+  * Edge-triggered, the connection is registered for both     *
+  * once and never modified; pausing is left to the loop.     *
+  *************************************************************
+*/
+static int conn_wants_input(const EvConn *c) {
+    return !c->dispatching && !c->closing && c->out_bytes < OUTPUT_HIGH_WATER;
+}
+
+static void uring_update_recv(EvReactor *r, int fd);
+
+static void conn_update_events(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (!c->open) return;
+    if (r->ring) {
+        uring_update_recv(r, fd);
+        return;
+    }
+    uint32_t want = 0;
+    if (r->server->edge_triggered) {
+        want = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    } else {
+        if (conn_wants_input(c)) want |= EPOLLIN;
+        // nothing can be sent while the next response is still being compressed or made
+        if (c->out_head && !chunk_waiting(c->out_head)) want |= EPOLLOUT;
+    }
+    if (want == c->events) return;
+    struct epoll_event ev = { .events = want, .data.fd = fd };
+    int op = !c->events ? EPOLL_CTL_ADD : !want ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+    if (epoll_ctl(r->epoll_fd, op, fd, &ev) < 0) {
+        perror("epoll_ctl");
+        return;
+    }
+    c->events = want;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Removes a client from the epoll set, closes it and        *
+  * drops its buffered input and output. Under io_uring the   *
+  * recv and send in flight hold the socket open; shutdown    *
+  * makes them complete, and the send keeps its chunks.       *
+  *************************************************************
+*/
+static void chunk_release(EvReactor *r, EvOutChunk *chunk);
+
+static void close_client(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (!c->open) return;
+    c->open = 0;
+    conn_idle_update(r, fd);
+    timer_wheel_cancel(&r->timers->wheel, &c->deadline);
+    if (r->ring) {
+        if (c->recv_armed || c->send_op) shutdown(fd, SHUT_RDWR);
+        if (c->send_op) {
+            c->send_op->orphans = c->out_head;
+            c->out_head = NULL;
+        }
+    } else if (c->events) {
+        epoll_ctl(r->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    }
+    close(fd);
+    if (c->buf && c->buf != c->inline_buf) buffer_pool_release(c->buf);
+    while (c->out_head) {
+        EvOutChunk *chunk = c->out_head;
+        c->out_head = chunk->next;
+        chunk_release(r, chunk);
+    }
+    // the ready list may still run through this slot
+    unsigned generation = c->generation;
+    int ready = c->ready;
+    int ready_next = c->ready_next;
+    memset(c, 0, offsetof(EvConn, inline_buf));
+    c->generation = generation;
+    c->ready = ready;
+    c->ready_next = ready_next;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Output chunks are recycled through a per-reactor free     *
+  * list; their data is always freed.                         *
+  *************************************************************
+*/
+static EvOutChunk *chunk_alloc(EvReactor *r) {
+    EvOutChunk *chunk = r->free_chunks;
+    if (!chunk) return malloc(sizeof(EvOutChunk));
+    r->free_chunks = chunk->next;
+    r->free_chunk_count--;
+    return chunk;
+}
+
+static void chunk_release(EvReactor *r, EvOutChunk *chunk) {
+    // the pool finishes the job anyway; it is freed when it comes back
+    if (chunk->job) chunk->job->chunk = NULL;
+    if (chunk->handler) chunk->handler->chunk = NULL;
+    if (chunk->entry) response_cache_release(chunk->entry);
+    else if (chunk->file) static_file_release(chunk->file);
+    else free(chunk->data);
+    if (r->free_chunk_count >= FREE_LIST_MAX) {
+        free(chunk);
+        return;
+    }
+    chunk->next = r->free_chunks;
+    r->free_chunks = chunk;
+    r->free_chunk_count++;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Drops the first sent bytes from the output queue          *
+  *************************************************************
+*/
+static void conn_written(EvReactor *r, EvConn *c, size_t sent) {
+    c->out_bytes -= sent;
+    while (c->out_head && !chunk_waiting(c->out_head) && sent >= c->out_head->len - c->out_head->off) {
+        EvOutChunk *chunk = c->out_head;
+        sent -= chunk->len - chunk->off;
+        c->out_head = chunk->next;
+        chunk_release(r, chunk);
+    }
+    if (!c->out_head) c->out_tail = NULL;
+    else c->out_head->off += sent;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Writes queued output until the socket would block, up to  *
+  * WRITEV_BATCH responses per syscall. A file range goes     *
+  * out with sendfile, straight from the page cache. Output   *
+  * stops at a response the compression pool or a handler     *
+  * worker still has.                                         *
+  * Closes the client on error, or once a closing             *
+  * connection has drained. Returns -1 if it was closed.      *
+  *************************************************************
+*/
+static int uring_flush_output(EvReactor *r, int fd);
+
+static int flush_output(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (r->ring) return uring_flush_output(r, fd);
+    while (c->out_head && !chunk_waiting(c->out_head)) {
+        EvOutChunk *head = c->out_head;
+        ssize_t n;
+        if (head->file && !head->data) {
+            off_t pos = head->file_off + head->off;
+            n = sendfile(fd, head->file->fd, &pos, head->len - head->off);
+            // the file was truncated under us; the response cannot be completed
+            if (n == 0) {
+                close_client(r, fd);
+                return -1;
+            }
+        } else {
+            struct iovec iov[WRITEV_BATCH];
+            int count = 0;
+            for (EvOutChunk *chunk = head; chunk && !chunk_waiting(chunk) && !(chunk->file && !chunk->data) && count < WRITEV_BATCH;
+                 chunk = chunk->next) {
+                iov[count++] = (struct iovec){ chunk->data + chunk->off, chunk->len - chunk->off };
+            }
+            // sendmsg rather than writev, for MSG_NOSIGNAL
+            struct msghdr msg = { .msg_iov = iov, .msg_iovlen = count };
+            n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            close_client(r, fd);
+            return -1;
+        }
+        conn_written(r, c, n);
+        c->last_active = r->now;
+    }
+    if (c->closing && !c->out_bytes && !c->compressing) {
+        close_client(r, fd);
+        return -1;
+    }
+    return 0;
+}
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Closes the client once everything queued for it has       *
+  * been written. Reading stops right away.                   *
+  *************************************************************
+*/
+static void close_after_flush(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (!c->open) return;
+    c->closing = 1;
+    if (flush_output(r, fd) == 0) conn_update_events(r, fd);
+}
+
+static void write_response(EvReactor *r, int fd, char *response_buffer, size_t response_size);
+static void conn_resume(EvReactor *r, int fd);
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Answers with a bare status line and closes the client     *
+  *************************************************************
+*/
+static void send_error_and_close(EvReactor *r, int fd, int status) {
+    const char *format =
+        "HTTP/1.1 %d %s\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    char *response = malloc(128);
+    int len = response ? snprintf(response, 128, format, status, http_status_text(status)) : 0;
+    write_response(r, fd, response, len);
+    close_after_flush(r, fd);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Advances the connection's parser over newly read bytes.   *
+  * The header search resumes where the last one stopped,     *
+  * so a request trickling in costs one scan in total. A      *
+  * chunked body is decoded as it arrives, in place, so the   *
+  * request at the front of buf looks the same as one sent    *
+  * with Content-Length once it is done.                      *
+  *************************************************************
+*/
+static void parse_reject(EvConn *c, int status) {
+    c->state = EvParseRejected;
+    c->reject_status = status;
+}
+
+static void parse_advance(EvConn *c) {
+    if (c->state == EvParseHeaders) {
+        // back up a little in case the blank line straddles two reads
+        size_t i = c->scanned > 3 ? c->scanned - 3 : 0;
+        for (; i < c->len && !c->header_len; i++) {
+            if (c->buf[i] != '\n') continue;
+            if (i + 1 < c->len && c->buf[i + 1] == '\n') c->header_len = i + 2;
+            else if (i + 2 < c->len && c->buf[i + 1] == '\r' && c->buf[i + 2] == '\n') c->header_len = i + 3;
+        }
+        c->scanned = c->len;
+        if (!c->header_len) return;
+        size_t content_length;
+        switch (http_body_framing(c->buf, c->header_len, &content_length)) {
+        case HTTP_BODY_LENGTH:
+            // past the limit, so the size check answers 413 without the sum wrapping
+            c->expected = content_length > MAX_REQUEST_SIZE ? MAX_REQUEST_SIZE + 1 : c->header_len + content_length;
+            c->state = EvParseBody;
+            break;
+        case HTTP_BODY_CHUNKED:
+            http_chunked_init(&c->chunked, c->header_len, c->header_len < MAX_REQUEST_SIZE ? MAX_REQUEST_SIZE - c->header_len : 0);
+            c->state = EvParseChunked;
+            break;
+        case HTTP_BODY_INVALID:
+            parse_reject(c, 400);
+            return;
+        }
+    }
+    if (c->state == EvParseBody && c->len >= c->expected) c->state = EvParseDone;
+    if (c->state == EvParseChunked) {
+        switch (http_chunked_decode(&c->chunked, c->buf, &c->len)) {
+        case HTTP_CHUNKED_MORE:
+            break;
+        case HTTP_CHUNKED_DONE:
+            c->expected = c->chunked.out;
+            c->state = EvParseDone;
+            break;
+        case HTTP_CHUNKED_INVALID:
+            parse_reject(c, 400);
+            break;
+        case HTTP_CHUNKED_TOO_LARGE:
+            parse_reject(c, 413);
+            break;
+        }
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Drops the request at the front of the buffer and keeps    *
+  * whatever was read after it for the next one               *
+  *************************************************************
+*/
+static void conn_consume(EvConn *c) {
+    size_t rest = c->len - c->expected;
+    if (rest) {
+        memmove(c->buf, c->buf + c->expected, rest);
+        c->buf[rest] = '\0';
+    } else if (c->buf) {
+        if (c->buf != c->inline_buf) buffer_pool_release(c->buf);
+        c->buf = NULL;
+        c->capacity = 0;
+    }
+    c->len = rest;
+    c->scanned = 0;
+    c->header_len = 0;
+    c->expected = 0;
+    c->state = EvParseHeaders;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Makes room in the input buffer for the next read.         *
+  * Returns 0 if the client was refused instead: 413 once     *
+  * the request outgrows MAX_REQUEST_SIZE, 400 or 413 for     *
+  * chunked framing the parser rejected, 500 if out of        *
+  * memory.                                                   *
+  *************************************************************
+*/
+static int conn_reserve(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (c->state == EvParseRejected) {
+        send_error_and_close(r, fd, c->reject_status);
+        return 0;
+    }
+    if (c->expected > MAX_REQUEST_SIZE || (!c->header_len && c->len >= MAX_REQUEST_SIZE)) {
+        send_error_and_close(r, fd, 413);
+        return 0;
+    }
+    // keep one byte for the terminator; once the body size is known, grow to it in one step,
+    // and to the end of the current chunk for a chunked one
+    size_t need = c->state == EvParseBody ? c->expected + 1 : c->len + 2;
+    if (c->state == EvParseChunked) need += c->chunked.left;
+    if (need > c->capacity) {
+        if (!c->buf && need <= sizeof(c->inline_buf)) {
+            c->buf = c->inline_buf;
+            c->capacity = sizeof(c->inline_buf);
+            return 1;
+        }
+        size_t want = c->capacity * 2 > need ? c->capacity * 2 : need;
+        if (want < READ_BUFFER_SIZE) want = READ_BUFFER_SIZE;
+        char *grown;
+        if (c->buf == c->inline_buf) {
+            // outgrew the inline buffer: move to a pooled one
+            size_t capacity;
+            grown = buffer_pool_acquire(want, &capacity);
+            if (grown) {
+                memcpy(grown, c->buf, c->len);
+                c->capacity = capacity;
+            }
+        } else {
+            grown = c->buf ? buffer_pool_grow(c->buf, c->len, want, &c->capacity)
+                           : buffer_pool_acquire(want, &c->capacity);
+        }
+        if (!grown) {
+            send_error_and_close(r, fd, 500);
+            return 0;
+        }
+        c->buf = grown;
+    }
+    return 1;
+}
+
+/**
+ *   __  __
+ *  |  \/  |
+ *  | \  / |
+ *  | |\/| |
+ *  | |  | |
+ *  |_|  |_| M4
+ *
+ * Reads data from a client socket and validates the request.
+ * Data is appended to the connection's buffer, which grows as needed, until the parser
+ * has a complete request. Returns 1 once one is buffered, 0 if more data is needed or
+ * the connection was closed. Requests over MAX_REQUEST_SIZE are refused with 413.
+ *
+ * Implementation hints:
+ *   1. Reads data from the client socket into a buffer.
+ *   2. If the read operation fails or returns zero, closes the socket and removes it from the epoll instance.
+ *
+ * APIs and system calls that you may need:
+ * - Socket operations: read(), close()
+ * - Epoll operations: epoll_ctl()
+ */
+static int read_and_validate_client_request(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    parse_advance(c);
+    while (c->state != EvParseDone) {
+        if (!conn_reserve(r, fd)) return 0;
+        ssize_t n = read(fd, c->buf + c->len, c->capacity - c->len - 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            c->readable = 0;
+            if (!c->len) conn_consume(c);
+            return 0;
+        }
+        if (n <= 0) {
+            close_client(r, fd);
+            return 0;
+        }
+        c->len += n;
+        c->buf[c->len] = '\0';
+        c->last_active = r->now;
+        conn_idle_update(r, fd);
+        parse_advance(c);
+    }
+    return 1;
+}
+
+
+/**
+ *   __  __
+ *  |  \/  |
+ *  | \  / |
+ *  | |\/| |
+ *  | |  | |
+ *  |_|  |_| M5
+ *
+ * Handles HTTP requests to the `/telemetry` endpoint, returning server telemetry data as a JSON response.
+ *
+ * Implementation hints:
+ *  1. Check if the HTTP method is "GET" and the path is "/telemetry".
+ *  2. If so, retrieve the current request count. Note: the counter will have to be updated somewhere else.
+ *  3. Format the telemetry data as a JSON string.
+ *  4. Construct an HTTP response with the JSON body, appropriate headers, and connection handling.
+ *  5. Write the response to the client socket.
+ *  6. If the connection is not keep-alive, close the client socket and remove it from the epoll instance.
+ *  7. Return 1 if the request was handled, 0 otherwise.
+ *  8. Ensure proper error handling and resource management.
+ *
+ * APIs and system calls that you may need:
+ * - String manipulation: snprintf(), strcmp()
+ * - Socket operations: write(), close()
+ * - Epoll operations: epoll_ctl()
+ * - telemetry_get_request_count: to get the number of handled requests.
+ * - telemetry_get_start_time: to get the server's start time.
+ */
+static int handle_telemetry_endpoint(EvReactor *r, int fd, EvHttpRequest *request, int keep_alive) {
+    if (!request->method || !request->path) return 0;
+    if (strcmp(request->method, "GET") != 0 || strcmp(request->path, "/telemetry") != 0) return 0;
+    struct timespec start, now;
+    telemetry_get_start_time(&start);
+    clock_gettime(CLOCK_REALTIME, &now);
+    char profile[256];
+    socket_tuning_describe(profile, sizeof(profile));
+    char body[1024];
+    int body_len = snprintf(body, sizeof(body),
+                            "{\"requests\":%d,\"responses_200\":%d,\"uptime_seconds\":%ld,"
+                            "\"read_timeouts\":%d,\"deadline_drops\":%d,\"fair_rejects\":%d,\"reactors\":%d,"
+                            "\"idle_timeouts\":%d,\"evictions\":%d,\"cache_hits\":%d,\"cache_misses\":%d,\"handler_workers\":%d,"
+                            "\"socket\":%s}",
+                            telemetry_get_request_count(), telemetry_get_200_responses(),
+                            (long)(now.tv_sec - start.tv_sec), telemetry_get_read_timeouts(),
+                            telemetry_get_deadline_drops(), telemetry_get_fair_rejects(),
+                            r->server->num_reactors, telemetry_get_idle_timeouts(), telemetry_get_evictions(),
+                            telemetry_get_cache_hits(), telemetry_get_cache_misses(), isolate_pool_size(), profile);
+    char *response = malloc(body_len + 256);
+    if (!response) {
+        write_response(r, fd, NULL, 0);
+    } else {
+        int len = snprintf(response, body_len + 256,
+                           "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Content-Length: %d\r\n"
+                           "%s"
+                           "Connection: %s\r\n"
+                           "\r\n"
+                           "%s",
+                           body_len, http_date_header(), keep_alive ? "keep-alive" : "close", body);
+        write_response(r, fd, response, len);
+    }
+    if (!keep_alive) close_after_flush(r, fd);
+    return 1;
+}
+
+/**
+ *   __  __
+ *  |  \/  |
+ *  | \  / |
+ *  | |\/| |
+ *  | |  | |
+ *  |_|  |_| M4
+ *
+ * Writes an HTTP response to the given file descriptor, handling both successful and error responses.
+ * The buffer is queued on the connection, which owns it from here on. Nothing is sent yet:
+ * conn_resume() flushes once all responses of a pipelined burst are queued, so the burst
+ * goes out in one syscall. Whatever the socket does not take is written on EPOLLOUT.
+ *
+ * Implementation hints:
+ *   1. Check if the provided response buffer is not NULL.
+ *   2. If the buffer is valid, write the response to the client and frees the buffer.
+ *   3. If the buffer is NULL, write a generic HTTP 500 Internal Server Error response to the client.
+ *
+ */
+static void write_response(EvReactor *r, int fd, char *response_buffer, size_t response_size) {
+    static const char internal_error[] =
+        "HTTP/1.1 500 Internal Server Error\r\n"
+        "Content-Length: 21\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "Internal Server Error";
+    EvConn *c = &r->conns[fd];
+    if (!c->open) {
+        free(response_buffer);
+        return;
+    }
+    if (!response_buffer) {
+        response_buffer = strdup(internal_error);
+        response_size = sizeof(internal_error) - 1;
+    }
+    EvOutChunk *chunk = response_buffer ? chunk_alloc(r) : NULL;
+    if (!chunk) {
+        free(response_buffer);
+        close_client(r, fd);
+        return;
+    }
+    *chunk = (EvOutChunk){ .data = response_buffer, .len = response_size };
+    if (c->out_tail) c->out_tail->next = chunk;
+    else c->out_head = chunk;
+    c->out_tail = chunk;
+    c->out_bytes += response_size;
+}
+
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queues a response built by the shared serializer: its     *
+  * status line, Date and header block gathered into one      *
+  * chunk, since the reactor's Date line changes under queued *
+  * output, and its body as a chunk of its own, not copied.   *
+  * A borrowed body lives in a cache entry whose reference    *
+  * passes to the chunk. With at set, the response fills that *
+  * placeholder rather than going to the back of the queue.   *
+  *************************************************************
+*/
+static void queue_response(EvReactor *r, int fd, EvOutChunk *at, HttpResponse *response, ResponseCacheEntry *borrowed) {
+    EvConn *c = &r->conns[fd];
+    struct iovec iov[HTTP_RESPONSE_IOV];
+    int count = http_response_iov(response, iov);
+    size_t head_len = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+    char *head = response->headers && c->open ? malloc(head_len) : NULL;
+    EvOutChunk *head_chunk = head ? (at ? at : chunk_alloc(r)) : NULL;
+    EvOutChunk *body_chunk = head_chunk && count > 3 ? chunk_alloc(r) : NULL;
+    if (!head_chunk || (count > 3 && !body_chunk)) {
+        free(response->headers);
+        response->headers = NULL;
+        free(head);
+        if (head_chunk && head_chunk != at) free(head_chunk);
+        if (borrowed) response_cache_release(borrowed);
+        else free(response->body);
+        response->body = NULL;
+        if (!c->open) return;
+        // a response that could not be made at all still gets an answer
+        if (!at && !head) {
+            write_response(r, fd, NULL, 0);
+            close_after_flush(r, fd);
+        } else {
+            close_client(r, fd);
+        }
+        return;
+    }
+    size_t off = 0;
+    for (int i = 0; i < 3; i++) {
+        memcpy(head + off, iov[i].iov_base, iov[i].iov_len);
+        off += iov[i].iov_len;
+    }
+    free(response->headers);
+    response->headers = NULL;
+    EvOutChunk *next = at ? at->next : NULL;
+    *head_chunk = (EvOutChunk){ .data = head, .len = head_len, .next = next };
+    EvOutChunk *last = head_chunk;
+    if (body_chunk) {
+        *body_chunk = (EvOutChunk){ .data = response->body, .len = response->body_len, .entry = borrowed, .next = next };
+        head_chunk->next = body_chunk;
+        last = body_chunk;
+    } else if (borrowed) {
+        response_cache_release(borrowed);
+    }
+    response->body = NULL;
+    if (!at) {
+        if (c->out_tail) c->out_tail->next = head_chunk;
+        else c->out_head = head_chunk;
+        c->out_tail = last;
+    } else if (c->out_tail == at) {
+        c->out_tail = last;
+    }
+    c->out_bytes += head_len + (body_chunk ? body_chunk->len : 0);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Takes back a finished compression. A response fills its   *
+  * placeholder, plain if compressing did not pay off, and    *
+  * its connection carries on writing. Variants are kept by   *
+  * the entry or file they were made for.                     *
+  *************************************************************
+*/
+static void finish_compress_job(EvReactor *r, EvCompressJob *job) {
+    CompressJob *done = &job->job;
+    if (job->kind == EvCompressStatic) {
+        if (done->output) {
+            job->file->encoded[done->encoding] = done->output;
+            job->file->encoded_len[done->encoding] = done->output_len;
+            done->output = NULL;
+        }
+        static_file_release(job->file);
+    } else if (job->entry) {
+        response_cache_attach_encoded(job->entry, done->encoding, done->output, done->output_len);
+        response_cache_release(job->entry);
+    }
+    if (job->kind == EvCompressResponse && job->chunk) {
+        EvOutChunk *chunk = job->chunk;
+        EvConn *c = &r->conns[job->fd];
+        EvResponseMeta meta = { job->status, job->content_type, job->cache_control, job->vary,
+                                job->has_etag ? job->etag : NULL, HTTP_ENCODING_IDENTITY, 1, -1 };
+        HttpResponse response;
+        char variant[VARIANT_ETAG_SIZE];
+        if (done->output) {
+            meta.encoding = done->encoding;
+            if (job->has_etag) {
+                variant_etag(job->etag, done->encoding, variant, sizeof(variant));
+                meta.etag = variant;
+            }
+            format_response(&meta, done->output_len, job->keep_alive, &response);
+            response.body = done->output;
+            response.body_len = done->output_len;
+            done->output = NULL;
+        } else {
+            format_response(&meta, done->input_len, job->keep_alive, &response);
+            response.body = job->body;
+            response.body_len = done->input_len;
+            job->body = NULL;
+        }
+        chunk->job = NULL;
+        c->compressing--;
+        queue_response(r, job->fd, chunk, &response, NULL);
+        if (c->open && flush_output(r, job->fd) == 0) conn_resume(r, job->fd);
+    }
+    free(done->output);
+    free(job->content_type);
+    free(job->cache_control);
+    free(job->vary);
+    free(job->body);
+    free(job);
+}
+
+static void handle_compress_event(EvReactor *r) {
+    CompressJob *done = (CompressJob *)job_completions_take(&r->compress_done);
+    while (done) {
+        CompressJob *next = (CompressJob *)done->job.next;
+        r->compress_inflight--;
+        finish_compress_job(r, (EvCompressJob *)done);
+        done = next;
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Hands a variant to the compression pool: a cache entry's  *
+  * body, or a static file read by the pool itself. The job   *
+  * holds a reference until it comes back. Without a pool it  *
+  * is made right here.                                       *
+  *************************************************************
+*/
+static void compress_in_background(EvReactor *r, EvCompressKind kind, HttpEncoding encoding, ResponseCacheEntry *entry,
+                                   StaticFile *file) {
+    EvCompressJob *job = calloc(1, sizeof(EvCompressJob));
+    if (!job) return;
+    job->kind = kind;
+    job->job.encoding = encoding;
+    if (entry) {
+        atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+        job->entry = entry;
+        job->job.input = entry->body;
+        job->job.input_len = entry->body_len;
+        job->job.input_fd = -1;
+    } else {
+        file->refs++;
+        job->file = file;
+        job->job.input_fd = file->fd;
+        job->job.input_len = file->size;
+    }
+    if (compress_submit(&job->job, &r->compress_done) == 0) {
+        r->compress_inflight++;
+        return;
+    }
+    compress_run(&job->job);
+    finish_compress_job(r, job);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Answers a request from the response cache without         *
+  * entering JS. Anything but a miss has been queued; on      *
+  * REVALIDATE the caller still owes the cache a refresh.     *
+  * A coding the entry has no variant for yet is made now,    *
+  * or by the pool for a large body.                          *
+  *************************************************************
+*/
+static ResponseCacheResult write_cached_response(EvReactor *r, int fd, const EvHttpRequest *request, int keep_alive,
+                                                 int may_revalidate) {
+    if (!request_cacheable(request)) return RESPONSE_CACHE_MISS;
+    ResponseCacheEntry *entry;
+    ResponseCacheResult result = response_cache_lookup(request->method, request->path, request_header, request,
+                                                       r->now, may_revalidate, &entry);
+    if (!entry) return result;
+    EvResponseMeta meta = { entry->status, entry->content_type, entry->cache_control, entry->vary, entry->etag,
+                            HTTP_ENCODING_IDENTITY, 0, (r->now - entry->stored_ms) / 1000 };
+    const char *body = entry->body;
+    size_t body_len = entry->body_len;
+    HttpEncoding encoding = response_encoding(request, entry->content_type, entry->body_len, &meta.vary_encoding);
+    if (encoding != HTTP_ENCODING_IDENTITY) {
+        ResponseCacheEncoded *encoded = atomic_load_explicit(&entry->encoded[encoding], memory_order_acquire);
+        if (!encoded && response_cache_claim_encoding(entry, encoding)) {
+            if (entry->body_len < COMPRESS_OFFLOAD_BYTES) {
+                char *data = NULL;
+                size_t len = 0;
+                http_compress(encoding, entry->body, entry->body_len, &data, &len);
+                response_cache_attach_encoded(entry, encoding, data, len);
+                free(data);
+                encoded = atomic_load_explicit(&entry->encoded[encoding], memory_order_acquire);
+            } else {
+                // this client gets the plain body; the ones after it get the variant
+                compress_in_background(r, EvCompressCached, encoding, entry, NULL);
+            }
+        }
+        if (encoded && encoded->len) {
+            meta.encoding = encoding;
+            body = encoded->data;
+            body_len = encoded->len;
+        }
+    }
+    char variant[VARIANT_ETAG_SIZE];
+    if (entry->etag) {
+        variant_etag(entry->etag, meta.encoding, variant, sizeof(variant));
+        meta.etag = variant;
+    }
+    // a revalidating client with the current version gets a 304 without the body
+    if (request_not_modified(request, meta.etag)) meta.status = 304;
+    HttpResponse response;
+    format_response(&meta, body_len, keep_alive, &response);
+    // the body is sent from the entry itself, which the queued chunk keeps alive
+    if (meta.status != 304 && strcmp(request->method, "HEAD") != 0) {
+        response.body = (char *)body;
+        response.body_len = body_len;
+    }
+    if (meta.status == 200) telemetry_increment_200_responses();
+    telemetry_increment_cache_hits();
+    queue_response(r, fd, NULL, &response, entry);
+    if (!keep_alive) close_after_flush(r, fd);
+    return result;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queues a placeholder for a response that the compression  *
+  * pool is encoding, so the responses after it keep their    *
+  * order; at is one already queued for it. Without a pool    *
+  * the job runs here and now.                                *
+  *************************************************************
+*/
+static void deferred_free(EvCompressJob *job) {
+    if (job->entry) response_cache_release(job->entry);
+    free(job->content_type);
+    free(job->cache_control);
+    free(job->vary);
+    free(job->body);
+    free(job);
+}
+
+static void write_deferred_response(EvReactor *r, int fd, EvOutChunk *at, EvCompressJob *job) {
+    EvConn *c = &r->conns[fd];
+    EvOutChunk *chunk = at ? at : c->open ? chunk_alloc(r) : NULL;
+    if (!chunk) {
+        deferred_free(job);
+        close_client(r, fd);
+        return;
+    }
+    if (at) {
+        at->job = job;
+    } else {
+        *chunk = (EvOutChunk){ .job = job };
+        if (c->out_tail) c->out_tail->next = chunk;
+        else c->out_head = chunk;
+        c->out_tail = chunk;
+    }
+    c->compressing++;
+    job->chunk = chunk;
+    job->fd = fd;
+    if (compress_submit(&job->job, &r->compress_done) == 0) {
+        r->compress_inflight++;
+        return;
+    }
+    compress_run(&job->job);
+    finish_compress_job(r, job);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Handler workers. A request runs on a worker's isolate     *
+  * while its response waits behind a placeholder, so the     *
+  * responses after it keep their order. The connection reads *
+  * nothing more meanwhile: the rest of its burst rides along *
+  * with the job and runs once the response is back. Without  *
+  * a pool the job runs here and now.                         *
+  *************************************************************
+*/
+static void free_pending_chain(EvReactor *r, EvPendingRequest *pending);
+static void run_burst(EvReactor *r, int fd, EvPendingRequest *burst);
+
+static void run_handler_job(PoolJob *base, void *engine) {
+    EvHandlerJob *job = (EvHandlerJob *)base;
+    const EvPendingRequest *pending = job->pending;
+    handle_request(engine, &pending->request, job->respond ? &job->response : NULL, pending->keep_alive, &job->deferred);
+}
+
+static void finish_handler_job(EvReactor *r, EvHandlerJob *job) {
+    int fd = job->fd;
+    EvConn *c = &r->conns[fd];
+    EvPendingRequest *pending = job->pending;
+    EvPendingRequest *rest = pending->next;
+    pending->next = NULL;
+    // the client may have gone away, and its fd been reused, while the handler ran
+    int live = c->open && c->generation == pending->generation;
+    if (job->chunk) {
+        EvOutChunk *chunk = job->chunk;
+        chunk->handler = NULL;
+        if (job->deferred) write_deferred_response(r, fd, chunk, job->deferred);
+        else queue_response(r, fd, chunk, &job->response, NULL);
+        if (!pending->keep_alive) close_after_flush(r, fd);
+    } else {
+        if (job->deferred) deferred_free(job->deferred);
+        http_response_free(&job->response);
+    }
+    free_pending_chain(r, pending);
+    free(job);
+    if (live) run_burst(r, fd, rest);
+    else free_pending_chain(r, rest);
+}
+
+static void handle_handler_event(EvReactor *r) {
+    PoolJob *done = job_completions_take(&r->handler_done);
+    while (done) {
+        PoolJob *next = done->next;
+        r->handler_inflight--;
+        finish_handler_job(r, (EvHandlerJob *)done);
+        done = next;
+    }
+}
+
+/* Hands a request and the rest of its burst to the workers. 0 if there are none; it is then run inline. */
+static int offload_request(EvReactor *r, int fd, EvPendingRequest *pending, EvPendingRequest *rest, int respond) {
+    if (!r->server->handler_window) return 0;
+    EvConn *c = &r->conns[fd];
+    EvHandlerJob *job = calloc(1, sizeof(EvHandlerJob));
+    EvOutChunk *chunk = job && respond ? chunk_alloc(r) : NULL;
+    if (!job || (respond && !chunk)) {
+        free(job);
+        return 0;
+    }
+    *job = (EvHandlerJob){ .job = { .run = run_handler_job, .done = &r->handler_done }, .respond = respond, .fd = fd,
+                           .pending = pending };
+    if (chunk) {
+        *chunk = (EvOutChunk){ .handler = job };
+        if (c->out_tail) c->out_tail->next = chunk;
+        else c->out_head = chunk;
+        c->out_tail = chunk;
+        job->chunk = chunk;
+    }
+    pending->next = rest;
+    if (isolate_pool_submit(&job->job) == 0) {
+        r->handler_inflight++;
+        return 1;
+    }
+    run_handler_job(&job->job, r->engine);
+    finish_handler_job(r, job);
+    return 1;
 }
 
 /**
@@ -299,142 +2356,600 @@ static void handle_new_connection(int server_fd, int epoll_fd, struct epoll_even
  *  | |  | |
  *  |_|  |_| M4
  *
- * Reads data from a client socket and validates the request.
+ * Handles a generic HTTP request by validating headers, invoking the request handler,
+ * and sending the appropriate response back to the client.
  *
  * Implementation hints:
- *   1. Reads data from the client socket into a buffer.
- *   2. If the read operation fails or returns zero, closes the socket and removes it from the epoll instance.
+ *   1. Validate the presence of the "Host" header; if missing, respond with a 400 Bad Request.
+ *   2. Determine if the request method is "HEAD" to handle it accordingly.
+ *   3. Call `handle_request` to process the request and obtain the response buffer and size.
+ *   4. If a response buffer is returned, add a "Date" header to it.
+ *   5. If the request method is "HEAD", ensure that only headers are sent in the response.
+ *   6. Write the response to the client using `write_response`.
+ *   7. If keep-alive is not requested, close the client socket and remove it from the epoll instance.
  *
  * APIs and system calls that you may need:
- * - Socket operations: read(), close()
+ * - String manipulation: strcmp(), strstr(), snprintf(), memcpy()
+ * - Socket operations: write(), close()
  * - Epoll operations: epoll_ctl()
+ *
+ * With ASP_HANDLER_THREADS set, the handler runs on a worker isolate instead. The job then
+ * takes over pending and the rest of its burst, and 1 is returned.
  */
-static int read_and_validate_client_request(int fd, char *buffer, struct epoll_event *ev, int epoll_fd) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static int handle_generic_request(EvReactor *r, int fd, EvPendingRequest *pending, EvPendingRequest *rest) {
+    EvHttpRequest *request = &pending->request;
+    int keep_alive = pending->keep_alive;
+    int has_host = 0;
+    for (int i = 0; i < request->header_count; i++) {
+        if (strcasecmp(request->headers[i].name, "Host") == 0) has_host = 1;
+    }
+    if (!request->method || !has_host) {
+        static const char bad_request[] =
+            "HTTP/1.1 400 Bad Request\r\n"
+            "Content-Length: 11\r\n"
+            "Connection: close\r\n"
+            "\r\n"
+            "Bad Request";
+        char *response = strdup(bad_request);
+        write_response(r, fd, response, response ? sizeof(bad_request) - 1 : 0);
+        close_after_flush(r, fd);
+        return 0;
+    }
+    ResponseCacheResult cached = write_cached_response(r, fd, request, keep_alive, 1);
+    if (cached == RESPONSE_CACHE_FRESH || cached == RESPONSE_CACHE_STALE) return 0;
+    if (cached == RESPONSE_CACHE_REVALIDATE) {
+        // the stale copy is on its way; refreshing it only updates the cache
+        if (r->conns[fd].open) flush_output(r, fd);
+        if (offload_request(r, fd, pending, rest, 0)) return 1;
+        handle_request(r->engine, request, NULL, keep_alive, NULL);
+        return 0;
+    }
+    if (request_cacheable(request)) telemetry_increment_cache_misses();
+    if (offload_request(r, fd, pending, rest, 1)) return 1;
+    // handle_request leaves out the body for HEAD
+    HttpResponse response;
+    EvCompressJob *deferred;
+    handle_request(r->engine, request, &response, keep_alive, &deferred);
+    if (deferred) write_deferred_response(r, fd, NULL, deferred);
+    else queue_response(r, fd, NULL, &response, NULL);
+    if (!keep_alive) close_after_flush(r, fd);
     return 0;
 }
 
-/**
- *   __  __
- *  |  \/  |
- *  | \  / |
- *  | |\/| |
- *  | |  | |
- *  |_|  |_| M5
- *
- * Handles HTTP requests to the `/telemetry` endpoint, returning server telemetry data as a JSON response.
- *
- * Implementation hints:
- *  1. Check if the HTTP method is "GET" and the path is "/telemetry".
- *  2. If so, retrieve the current request count. Note: the counter will have to be updated somewhere else.
- *  3. Format the telemetry data as a JSON string.
- *  4. Construct an HTTP response with the JSON body, appropriate headers, and connection handling.
- *  5. Write the response to the client socket.
- *  6. If the connection is not keep-alive, close the client socket and remove it from the epoll instance.
- *  7. Return 1 if the request was handled, 0 otherwise.
- *  8. Ensure proper error handling and resource management.
- *
- * APIs and system calls that you may need:
- * - String manipulation: snprintf(), strcmp()
- * - Socket operations: write(), close()
- * - Epoll operations: epoll_ctl()
- * - telemetry_get_request_count: to get the number of handled requests.
- * - telemetry_get_start_time: to get the server's start time.
- */
-static int handle_telemetry_endpoint(int fd, int epoll_fd, EvHttpRequest *request, int keep_alive) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-    return 0;
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queues a range of a static file after its headers. The    *
+  * chunk takes over the caller's reference. io_uring has no  *
+  * sendfile, so there the range is read into memory.         *
+  *************************************************************
+*/
+static void write_file_range(EvReactor *r, int fd, StaticFile *file, off_t start, off_t length) {
+    EvConn *c = &r->conns[fd];
+    if (!c->open) {
+        static_file_release(file);
+        return;
+    }
+    if (r->ring) {
+        char *data = malloc(length);
+        off_t done = 0;
+        while (data && done < length) {
+            ssize_t n = pread(file->fd, data + done, length - done, start + done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += n;
+        }
+        static_file_release(file);
+        if (done < length) {
+            free(data);
+            close_client(r, fd);
+            return;
+        }
+        write_response(r, fd, data, length);
+        return;
+    }
+    EvOutChunk *chunk = chunk_alloc(r);
+    if (!chunk) {
+        static_file_release(file);
+        close_client(r, fd);
+        return;
+    }
+    *chunk = (EvOutChunk){ .file = file, .file_off = start, .len = length };
+    if (c->out_tail) c->out_tail->next = chunk;
+    else c->out_head = chunk;
+    c->out_tail = chunk;
+    c->out_bytes += length;
+}
+
+/* Queues a compressed variant held by a static file, sent straight from the file's buffer. */
+static void write_file_variant(EvReactor *r, int fd, StaticFile *file, HttpEncoding encoding) {
+    EvConn *c = &r->conns[fd];
+    EvOutChunk *chunk = c->open ? chunk_alloc(r) : NULL;
+    if (!chunk) {
+        static_file_release(file);
+        if (c->open) close_client(r, fd);
+        return;
+    }
+    *chunk = (EvOutChunk){ .data = file->encoded[encoding], .len = file->encoded_len[encoding], .file = file };
+    if (c->out_tail) c->out_tail->next = chunk;
+    else c->out_head = chunk;
+    c->out_tail = chunk;
+    c->out_bytes += chunk->len;
+}
+
+/* A short plain-text response of the static file handler, with optional extra header lines. */
+static void write_static_status(EvReactor *r, int fd, int status, const char *extra, int keep_alive, int is_head) {
+    const char *text = http_status_text(status);
+    size_t status_len;
+    const char *status_line = http_status_line(status, &status_len);
+    const char *format =
+        "%s"
+        "Content-Type: text/plain\r\n"
+        "Content-Length: %zu\r\n"
+        "%s"
+        "%s"
+        "Server: asp-v8/1.0\r\n"
+        "Connection: %s\r\n"
+        "\r\n"
+        "%s";
+    const char *conn = keep_alive ? "keep-alive" : "close";
+    const char *date = http_date_header();
+    const char *body = is_head ? "" : text;
+    int len = snprintf(NULL, 0, format, status_line, strlen(text), extra, date, conn, body);
+    char *response = malloc(len + 1);
+    if (response) snprintf(response, len + 1, format, status_line, strlen(text), extra, date, conn, body);
+    write_response(r, fd, response, response ? len : 0);
+    if (!keep_alive) close_after_flush(r, fd);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Serves paths under an ASP.serveStatic prefix without      *
+  * entering JS: GET and HEAD of regular files from the       *
+  * reactor's open-file cache, with single byte ranges.       *
+  * Compressible files are sent as a gzip or deflate variant  *
+  * kept with the open file when the client accepts one.      *
+  * Returns 1 if the request was handled.                     *
+  *************************************************************
+*/
+static int handle_static_request(EvReactor *r, int fd, EvHttpRequest *request, int keep_alive) {
+    if (!request->method || !request->path) return 0;
+    char path[STATIC_PATH_MAX];
+    int route = static_files_resolve(request->path, path, sizeof(path));
+    if (route == 0) return 0;
+    int is_head = strcmp(request->method, "HEAD") == 0;
+    if (!is_head && strcmp(request->method, "GET") != 0) {
+        write_static_status(r, fd, 405, "Allow: GET, HEAD\r\n", keep_alive, 0);
+        return 1;
+    }
+    StaticFile *file = route > 0 ? static_file_open(r->static_cache, path, r->now) : NULL;
+    if (!file) {
+        write_static_status(r, fd, route > 0 && errno == EACCES ? 403 : 404, "", keep_alive, is_head);
+        return 1;
+    }
+
+    const char *range_hdr = NULL;
+    for (int i = 0; i < request->header_count; i++) {
+        if (strcasecmp(request->headers[i].name, "Range") == 0) range_hdr = request->headers[i].value;
+    }
+    off_t start = 0;
+    off_t length = file->size;
+    int range = static_file_parse_range(range_hdr, file->size, &start, &length);
+    char extra[128];
+    if (range < 0) {
+        snprintf(extra, sizeof(extra), "Content-Range: bytes */%lld\r\n", (long long)file->size);
+        static_file_release(file);
+        write_static_status(r, fd, 416, extra, keep_alive, is_head);
+        return 1;
+    }
+    int status = range > 0 ? 206 : 200;
+    extra[0] = '\0';
+    if (range > 0) {
+        snprintf(extra, sizeof(extra), "Content-Range: bytes %lld-%lld/%lld\r\n",
+                 (long long)start, (long long)(start + length - 1), (long long)file->size);
+    }
+    // whole files of moderate size may go out compressed; ranges always refer to the plain file
+    int vary = 0;
+    HttpEncoding encoding = HTTP_ENCODING_IDENTITY;
+    if (range == 0 && file->size <= STATIC_COMPRESS_MAX) {
+        encoding = response_encoding(request, file->content_type, file->size, &vary);
+    }
+    if (encoding != HTTP_ENCODING_IDENTITY && !(file->encodings_tried & (1u << encoding))) {
+        file->encodings_tried |= 1u << encoding;
+        if (file->size < COMPRESS_OFFLOAD_BYTES) {
+            char data[COMPRESS_OFFLOAD_BYTES];
+            if (pread(file->fd, data, file->size, 0) == file->size) {
+                http_compress(encoding, data, file->size, &file->encoded[encoding], &file->encoded_len[encoding]);
+            }
+        } else {
+            // served plain this once; the variant is there for the next client
+            compress_in_background(r, EvCompressStatic, encoding, NULL, file);
+        }
+    }
+    if (encoding != HTTP_ENCODING_IDENTITY && !file->encoded[encoding]) encoding = HTTP_ENCODING_IDENTITY;
+    if (encoding != HTTP_ENCODING_IDENTITY) {
+        length = file->encoded_len[encoding];
+        snprintf(extra, sizeof(extra), "Content-Encoding: %s\r\n", http_encoding_name(encoding));
+    }
+    if (vary) strcat(extra, "Vary: Accept-Encoding\r\n");
+    char modified[64];
+    struct tm tm;
+    strftime(modified, sizeof(modified), "%a, %d %b %Y %H:%M:%S GMT", gmtime_r(&file->mtime, &tm));
+    size_t status_len;
+    const char *status_line = http_status_line(status, &status_len);
+    const char *date = http_date_header();
+    const char *format =
+        "%s"
+        "Content-Type: %s\r\n"
+        "Content-Length: %lld\r\n"
+        "%s"
+        "Accept-Ranges: bytes\r\n"
+        "Last-Modified: %s\r\n"
+        "%s"
+        "Server: asp-v8/1.0\r\n"
+        "Connection: %s\r\n"
+        "\r\n";
+    const char *conn = keep_alive ? "keep-alive" : "close";
+    int len = snprintf(NULL, 0, format, status_line, file->content_type, (long long)length, extra, modified, date, conn);
+    char *headers = malloc(len + 1);
+    if (headers) {
+        snprintf(headers, len + 1, format, status_line, file->content_type, (long long)length, extra, modified, date,
+                 conn);
+    }
+    write_response(r, fd, headers, headers ? len : 0);
+    if (headers && !is_head && encoding != HTTP_ENCODING_IDENTITY) write_file_variant(r, fd, file, encoding);
+    else if (headers && !is_head && length > 0) write_file_range(r, fd, file, start, length);
+    else static_file_release(file);
+    if (status == 200) telemetry_increment_200_responses();
+    if (!headers || !keep_alive) close_after_flush(r, fd);
+    return 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Parses the request at the front of the buffer and         *
+  * consumes it. The cost of the request is added to *cost.   *
+  * A Keep-Alive header can only shorten the connection's     *
+  * timeout and request limit; the request that reaches the   *
+  * limit closes the connection.                              *
+  *************************************************************
+*/
+/* Takes a request from the free list; its arena comes with it. */
+static EvPendingRequest *pending_alloc(EvReactor *r) {
+    EvPendingRequest *pending = r->free_requests;
+    if (!pending) return calloc(1, sizeof(EvPendingRequest));
+    r->free_requests = pending->next;
+    r->free_request_count--;
+    pending->next = NULL;
+    return pending;
+}
+
+static EvPendingRequest *parse_buffered_request(EvReactor *r, EvConn *c, size_t *cost) {
+    EvPendingRequest *pending = pending_alloc(r);
+    if (!pending) return NULL;
+    pending->generation = c->generation;
+    // terminate the request in place; pipelined bytes after it are put back below
+    char *raw = c->buf;
+    size_t len = c->expected;
+    // each string is a piece of the request plus its terminator; the keep-alive ones repeat header bytes
+    if (!arena_reserve(&pending->arena, len + c->header_len + 2 * MAX_HEADERS + 8)) {
+        free(pending->arena.data);
+        free(pending);
+        return NULL;
+    }
+    char saved = raw[len];
+    raw[len] = '\0';
+    parse_request(raw, &pending->request, &pending->arena);
+    telemetry_increment_request_count();
+    int keep_alive_timeout, keep_alive_max;
+    char *http_version = NULL;
+    char *connection_hdr = NULL;
+    char *keep_alive_hdr = NULL;
+    parse_keep_alive_headers(raw, &pending->arena, &http_version, &connection_hdr, &keep_alive_hdr, &pending->keep_alive, &keep_alive_timeout, &keep_alive_max);
+    if (keep_alive_hdr && find_token(keep_alive_hdr, "timeout=") && keep_alive_timeout * 1000LL < c->idle_ms) {
+        c->idle_ms = keep_alive_timeout * 1000LL;
+        // the deadline timer only ever moves later by itself
+        timer_wheel_add(&r->timers->wheel, &c->deadline, r->now + c->idle_ms);
+    }
+    if (keep_alive_hdr && find_token(keep_alive_hdr, "max=") && c->requests + keep_alive_max < c->max_requests) {
+        c->max_requests = c->requests + keep_alive_max;
+    }
+    if (++c->requests >= c->max_requests || r->server->keep_alive_timeout <= 0) pending->keep_alive = 0;
+    raw[len] = saved;
+    conn_consume(c);
+    *cost += len;
+    return pending;
+}
+
+/* Returns a burst to the free list. Arenas that grew for a large request are not kept. */
+static void free_pending_chain(EvReactor *r, EvPendingRequest *pending) {
+    while (pending) {
+        EvPendingRequest *next = pending->next;
+        if (pending->arena.capacity > ARENA_KEEP_MAX || r->free_request_count >= FREE_LIST_MAX) {
+            free(pending->arena.data);
+            free(pending);
+        } else {
+            EvArena arena = pending->arena;
+            memset(pending, 0, sizeof(*pending));
+            pending->arena = arena;
+            pending->next = r->free_requests;
+            r->free_requests = pending;
+            r->free_request_count++;
+        }
+        pending = next;
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queues every complete request in the buffer, up to        *
+  * PIPELINE_DEPTH, as one dispatch entry so a pipelined      *
+  * burst runs in order and its responses leave together.     *
+  * A request that closes the connection ends the burst.      *
+  *************************************************************
+*/
+static void queue_client_requests(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    EvPendingRequest *head = NULL;
+    EvPendingRequest **tail = &head;
+    size_t cost = 0;
+    int depth = 0;
+    parse_advance(c);
+    while (c->open && !c->closing && c->state == EvParseDone && depth < PIPELINE_DEPTH) {
+        EvPendingRequest *pending = parse_buffered_request(r, c, &cost);
+        if (!pending) {
+            send_error_and_close(r, fd, 500);
+            break;
+        }
+        // telemetry, static files and cached responses at the head of the line are answered inline, they never wait behind the handler queue
+        if (!head && (handle_telemetry_endpoint(r, fd, &pending->request, pending->keep_alive) ||
+                      handle_static_request(r, fd, &pending->request, pending->keep_alive) ||
+                      write_cached_response(r, fd, &pending->request, pending->keep_alive, 0) != RESPONSE_CACHE_MISS)) {
+            free_pending_chain(r, pending);
+            parse_advance(c);
+            continue;
+        }
+        *tail = pending;
+        tail = &pending->next;
+        depth++;
+        if (!pending->keep_alive) break;
+        parse_advance(c);
+    }
+    if (!head) return;
+    if (!c->open) {
+        free_pending_chain(r, head);
+        return;
+    }
+
+    char flow[FAIR_QUEUE_KEY_SIZE] = "";
+    const EvServer *server = r->server;
+    const EvHttpRequest *request = &head->request;
+    if (server->fair_by_peer) fair_queue_peer_key(fd, flow, sizeof(flow));
+    for (int i = 0; server->fair_header && i < request->header_count; i++) {
+        if (strcasecmp(request->headers[i].name, server->fair_header) == 0) {
+            snprintf(flow, sizeof(flow), "h:%s", request->headers[i].value);
+            break;
+        }
+    }
+    FairQueueItem item = { .cost = cost, .fd = fd, .data = head };
+    if (fair_queue_push(r->dispatch_queue, flow, &item) < 0) {
+        free_pending_chain(r, head);
+        write_response(r, fd, NULL, 0);
+        close_after_flush(r, fd);
+        return;
+    }
+    // stop reading while the burst waits, so later requests are not parsed ahead of it
+    c->dispatching = 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Picks the connection up again after a burst: queues the   *
+  * next complete requests, flushes the queued responses      *
+  * and goes back to waiting for input.                       *
+  *************************************************************
+*/
+static void conn_mark_ready(EvReactor *r, int fd);
+
+static void conn_resume(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (c->open && !c->dispatching && !c->closing && c->len && c->out_bytes < OUTPUT_HIGH_WATER) {
+        queue_client_requests(r, fd);
+    }
+    if (c->open && c->out_bytes && flush_output(r, fd) < 0) return;
+    conn_update_events(r, fd);
+    conn_idle_update(r, fd);
+    // edge-triggered, input that arrived while reading was paused has to be picked up by hand
+    if (r->server->edge_triggered && c->open && c->readable && conn_wants_input(c)) conn_mark_ready(r, fd);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Initial handling of client requests                       *
+  *************************************************************
+*/
+static void handle_client_event(EvReactor *r, int fd) {
+    if (read_and_validate_client_request(r, fd)) conn_resume(r, fd);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Runs up to DISPATCH_BATCH queued bursts through JS in     *
+  * fair-queue order, then returns to epoll so newly arrived  *
+  * clients join the round before a backlog is drained.       *
+  * Kept-alive connections go back to reading afterwards.     *
+  * With handler workers, a reactor keeps at most             *
+  * HANDLER_WINDOW bursts per worker on them; the rest wait   *
+  * here, so the fair queue still picks who goes next.        *
+  *************************************************************
+*/
+static void run_burst(EvReactor *r, int fd, EvPendingRequest *burst) {
+    EvConn *c = &r->conns[fd];
+    while (burst && c->open && !c->closing) {
+        EvPendingRequest *pending = burst;
+        burst = pending->next;
+        pending->next = NULL;
+        if (!handle_telemetry_endpoint(r, fd, &pending->request, pending->keep_alive) &&
+            !handle_static_request(r, fd, &pending->request, pending->keep_alive) &&
+            handle_generic_request(r, fd, pending, burst)) {
+            // finish_handler_job carries on with the rest
+            return;
+        }
+        free_pending_chain(r, pending);
+    }
+    free_pending_chain(r, burst);
+    c->dispatching = 0;
+    conn_resume(r, fd);
+}
+
+static int dispatch_ready(const EvReactor *r) {
+    int window = r->server->handler_window;
+    return fair_queue_size(r->dispatch_queue) && (!window || r->handler_inflight < window);
 }
 
-/**
- *   __  __
- *  |  \/  |
- *  | \  / |
- *  | |\/| |
- *  | |  | |
- *  |_|  |_| M4
- *
- * Writes an HTTP response to the given file descriptor, handling both successful and error responses.
- *
- * Implementation hints:
- *   1. Check if the provided response buffer is not NULL.
- *   2. If the buffer is valid, write the response to the client and frees the buffer.
- *   3. If the buffer is NULL, write a generic HTTP 500 Internal Server Error response to the client.
- *
- */
-static void write_response(int fd, char *response_buffer, size_t response_size) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static void dispatch_pending(EvReactor *r) {
+    FairQueueItem item;
+    for (int i = 0; i < DISPATCH_BATCH && dispatch_ready(r) && fair_queue_pop(r->dispatch_queue, &item) == 0; i++) {
+        EvPendingRequest *burst = item.data;
+        EvConn *c = &r->conns[item.fd];
+        // the client may have gone away while its requests waited
+        if (c->open && c->generation == burst->generation) run_burst(r, item.fd, burst);
+        else free_pending_chain(r, burst);
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Edge-triggered ready list: connections that may have      *
+  * unread input but will get no new EPOLLIN edge for it.     *
+  * The loop reads them before the next epoll_wait.           *
+  *************************************************************
+*/
+static void conn_mark_ready(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (c->ready) return;
+    c->ready = 1;
+    c->ready_next = -1;
+    if (r->ready_tail >= 0) r->conns[r->ready_tail].ready_next = fd;
+    else r->ready_head = fd;
+    r->ready_tail = fd;
 }
 
+static void drain_ready(EvReactor *r) {
+    // connections marked while this runs wait for the next round
+    int fd = r->ready_head;
+    r->ready_head = r->ready_tail = -1;
+    while (fd >= 0) {
+        EvConn *c = &r->conns[fd];
+        int next = c->ready_next;
+        c->ready = 0;
+        if (c->open && c->readable && conn_wants_input(c)) handle_client_event(r, fd);
+        fd = next;
+    }
+}
 
-/**
- *   __  __
- *  |  \/  |
- *  | \  / |
- *  | |\/| |
- *  | |  | |
- *  |_|  |_| M4
- *
- * Handles a generic HTTP request by validating headers, invoking the request handler,
- * and sending the appropriate response back to the client.
- *
- * Implementation hints:
- *   1. Validate the presence of the "Host" header; if missing, respond with a 400 Bad Request.
- *   2. Determine if the request method is "HEAD" to handle it accordingly.
- *   3. Call `handle_request` to process the request and obtain the response buffer and size.
- *   4. If a response buffer is returned, add a "Date" header to it.
- *   5. If the request method is "HEAD", ensure that only headers are sent in the response.
- *   6. Write the response to the client using `write_response`.
- *   7. If keep-alive is not requested, close the client socket and remove it from the epoll instance.
- *
- * APIs and system calls that you may need:
- * - String manipulation: strcmp(), strstr(), snprintf(), memcpy()
- * - Socket operations: write(), close()
- * - Epoll operations: epoll_ctl()
- *
- */
-static void handle_generic_request(V8Engine *engine, int fd, int epoll_fd, EvHttpRequest *request, int keep_alive) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * io_uring: keeps a recv armed while the connection wants   *
+  * input, the io_uring counterpart of registering EPOLLIN.   *
+  * The recv is multishot and picks its buffers from the      *
+  * reactor's buffer ring; pausing cancels it.                *
+  *************************************************************
+*/
+static void uring_update_recv(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    int want = conn_wants_input(c);
+    uint64_t recv_data = URING_DATA(URING_OP_RECV, fd, c->generation);
+    if (want && !c->recv_armed) {
+        struct io_uring_sqe *sqe = uring_get_sqe(r->ring);
+        if (!sqe) return;
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fd;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = URING_BUFFER_GROUP;
+        if (!r->recv_single) sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->user_data = recv_data;
+        c->recv_armed = 1;
+    } else if (!want && c->recv_armed == 1) {
+        struct io_uring_sqe *sqe = uring_get_sqe(r->ring);
+        if (!sqe) return;
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = recv_data;
+        sqe->user_data = URING_DATA(URING_OP_CANCEL, fd, c->generation);
+        c->recv_armed = 2;
+    }
 }
 
 /*
@@ -447,17 +2962,64 @@ static void handle_generic_request(V8Engine *engine, int fd, int epoll_fd, EvHtt
   *   ██║  ██║███████║██║                                     *
   *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
   *                                                           *
+  * io_uring: hands up to WRITEV_BATCH queued chunks to one   *
+  * sendmsg. Only one send is in flight per connection, the   *
+  * next one is submitted when it completes, so responses     *
+  * cannot overtake each other. Same return as flush_output.  *
   *************************************************************
 */
-static void cleanup_request(EvHttpRequest *request) {
-    for (size_t i = 0; i < request->header_count; i++) {
-        free(request->headers[i].name);
-        free(request->headers[i].value);
+static int uring_flush_output(EvReactor *r, int fd) {
+    EvConn *c = &r->conns[fd];
+    if (c->send_op) return 0;
+    if (c->closing && !c->out_bytes && !c->compressing) {
+        close_client(r, fd);
+        return -1;
+    }
+    if (!c->out_head || chunk_waiting(c->out_head)) return 0;
+    EvSendOp *op = malloc(sizeof(EvSendOp));
+    struct io_uring_sqe *sqe = op ? uring_get_sqe(r->ring) : NULL;
+    if (!sqe) {
+        free(op);
+        close_client(r, fd);
+        return -1;
+    }
+    int count = 0;
+    for (EvOutChunk *chunk = c->out_head; chunk && !chunk_waiting(chunk) && count < WRITEV_BATCH; chunk = chunk->next) {
+        op->iov[count++] = (struct iovec){ chunk->data + chunk->off, chunk->len - chunk->off };
     }
+    op->fd = fd;
+    op->msg = (struct msghdr){ .msg_iov = op->iov, .msg_iovlen = count };
+    op->orphans = NULL;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)&op->msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+    c->send_op = op;
+    return 0;
+}
 
-    free(request->method);
-    free(request->path);
-    free(request->body);
+static void uring_handle_send(EvReactor *r, EvSendOp *op, int res) {
+    int fd = op->fd;
+    EvConn *c = &r->conns[fd];
+    int current = c->open && c->send_op == op;
+    while (op->orphans) {
+        EvOutChunk *chunk = op->orphans;
+        op->orphans = chunk->next;
+        chunk_release(r, chunk);
+    }
+    free(op);
+    if (!current) return;
+    c->send_op = NULL;
+    if (res < 0) {
+        close_client(r, fd);
+        return;
+    }
+    conn_written(r, c, res);
+    c->last_active = r->now;
+    // submits the rest, or closes a closing connection that has now drained
+    if (flush_output(r, fd) == 0) conn_resume(r, fd);
 }
 
 /*
@@ -470,28 +3032,153 @@ static void cleanup_request(EvHttpRequest *request) {
   *   ██║  ██║███████║██║                                     *
   *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
   *                                                           *
-  * Initial handling of client requests                       *
+  * io_uring: copies received bytes from a ring buffer into   *
+  * the connection's input buffer, so the buffer can go back  *
+  * to the kernel straight away.                              *
   *************************************************************
 */
-static void handle_client_event(V8Engine *engine, int fd, struct epoll_event *ev, int epoll_fd) {
-    char buffer[READ_BUFFER_SIZE] = { 0 };
-    if (!read_and_validate_client_request(fd, buffer, ev, epoll_fd)) return;
-    EvHttpRequest request = { 0 };
-    parse_http_request_with_header(buffer, &request);
-    int keep_alive, keep_alive_timeout, keep_alive_max;
-    char *http_version = NULL;
-    char *connection_hdr = NULL;
-    char *keep_alive_hdr = NULL;
-    parse_keep_alive_headers(buffer, &http_version, &connection_hdr, &keep_alive_hdr, &keep_alive, &keep_alive_timeout, &keep_alive_max);
-    if (handle_telemetry_endpoint(fd, epoll_fd, &request, keep_alive)) {
-        cleanup_request(&request);
+static void conn_append(EvReactor *r, int fd, const char *data, size_t n) {
+    EvConn *c = &r->conns[fd];
+    c->last_active = r->now;
+    while (n && !c->closing) {
+        if (!conn_reserve(r, fd)) return;
+        size_t room = c->capacity - c->len - 1;
+        size_t take = n < room ? n : room;
+        memcpy(c->buf + c->len, data, take);
+        c->len += take;
+        c->buf[c->len] = '\0';
+        data += take;
+        n -= take;
+        conn_idle_update(r, fd);
+        parse_advance(c);
+    }
+    // like the read loop, refuse an oversized request as soon as its headers are in
+    if (!c->closing && c->state != EvParseDone) conn_reserve(r, fd);
+}
+
+static void uring_handle_recv(EvReactor *r, const struct io_uring_cqe *cqe) {
+    int fd = URING_DATA_FD(cqe->user_data);
+    EvConn *c = &r->conns[fd];
+    int res = cqe->res;
+    int bid = cqe->flags & IORING_CQE_F_BUFFER ? (int)(cqe->flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+    // completions of a connection that has since been closed are dropped
+    int current = c->open && (c->generation & 0xffffff) == URING_DATA_GENERATION(cqe->user_data);
+    if (current && !(cqe->flags & IORING_CQE_F_MORE)) c->recv_armed = 0;
+    if (current && res > 0 && bid >= 0) conn_append(r, fd, uring_buf_ring_buffer(&r->recv_bufs, bid), res);
+    if (bid >= 0) uring_buf_ring_recycle(&r->recv_bufs, bid);
+    if (!current) return;
+    if (res == -EINVAL && !r->recv_single) {
+        // kernels before 6.0 have no multishot recv; fall back to one recv at a time
+        r->recv_single = 1;
+    } else if (res <= 0 && res != -ENOBUFS && res != -ECANCELED) {
+        close_client(r, fd);
         return;
     }
-    handle_generic_request(engine, fd, epoll_fd, &request, keep_alive);
-    cleanup_request(&request);
+    conn_resume(r, fd);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * io_uring: a multishot accept on the listening socket and  *
+  * multishot polls on the timer and on the eventfd of the    *
+  * compression pool. All are re-armed when the kernel ends   *
+  * them.                                                     *
+  *************************************************************
+*/
+static void uring_arm_accept(EvReactor *r) {
+    struct io_uring_sqe *sqe = uring_get_sqe(r->ring);
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = r->server_fd;
+    // client sockets stay blocking; the ring does the waiting
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = URING_DATA(URING_OP_ACCEPT, r->server_fd, 0);
+}
+
+// the eventfd of a pool's completions: compression, handlers or fs
+static void uring_arm_wake(EvReactor *r, int event_fd) {
+    struct io_uring_sqe *sqe = uring_get_sqe(r->ring);
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = event_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = URING_DATA(URING_OP_WAKE, event_fd, 0);
+}
+
+static void uring_arm_timer(EvReactor *r) {
+    struct io_uring_sqe *sqe = uring_get_sqe(r->ring);
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = r->timer_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = URING_DATA(URING_OP_TIMER, r->timer_fd, 0);
 }
 
+static void uring_handle_accept(EvReactor *r, const struct io_uring_cqe *cqe) {
+    if (!(cqe->flags & IORING_CQE_F_MORE) && server_running_eb) uring_arm_accept(r);
+    int client_fd = cqe->res;
+    if (client_fd < 0) {
+        // out of fds: free one for the next connection by closing the longest idle one
+        if ((client_fd == -EMFILE || client_fd == -ENFILE) && evict_idle(r)) return;
+        if (client_fd != -ECANCELED) fprintf(stderr, "accept: %s\n", strerror(-client_fd));
+        return;
+    }
+    if (client_fd >= r->max_conns) {
+        close(client_fd);
+        return;
+    }
+    socket_tune_accepted(client_fd);
+    EvConn *c = &r->conns[client_fd];
+    c->open = 1;
+    c->generation++;
+    conn_update_events(r, client_fd);
+    if (!c->recv_armed) {
+        close(client_fd);
+        c->open = 0;
+        return;
+    }
+    conn_open(r, client_fd);
+}
 
+static void uring_handle_completion(EvReactor *r, const struct io_uring_cqe *cqe) {
+    switch (cqe->user_data & URING_OP_MASK) {
+    case URING_OP_SEND:
+        uring_handle_send(r, (EvSendOp *)(uintptr_t)cqe->user_data, cqe->res);
+        break;
+    case URING_OP_ACCEPT:
+        uring_handle_accept(r, cqe);
+        break;
+    case URING_OP_RECV:
+        uring_handle_recv(r, cqe);
+        break;
+    case URING_OP_TIMER:
+        if (cqe->res >= 0) handle_timer_event(r);
+        if (!(cqe->flags & IORING_CQE_F_MORE) && server_running_eb) uring_arm_timer(r);
+        break;
+    case URING_OP_WAKE: {
+        int event_fd = URING_DATA_FD(cqe->user_data);
+        if (cqe->res >= 0 && event_fd == r->handler_done.event_fd) handle_handler_event(r);
+        else if (cqe->res >= 0 && event_fd == r->fs_done.event_fd) handle_fs_event(r);
+        else if (cqe->res >= 0) handle_compress_event(r);
+        if (!(cqe->flags & IORING_CQE_F_MORE) && server_running_eb) uring_arm_wake(r, event_fd);
+        break;
+    }
+    default:
+        // the recv a cancel targeted reports the outcome itself
+        break;
+    }
+}
 /**
  *   __  __
  *  |  \/  |
@@ -505,23 +3192,21 @@ static void handle_client_event(V8Engine *engine, int fd, struct epoll_event *ev
  * Steps performed:
  *   1. Creates a timer file descriptor using `timerfd_create`.
  *   2. Configures the timer to trigger at specified intervals using `timerfd_settime`.
+ *      It is armed for the timer wheel's next deadline, including timers the app script set.
  *
  * APIs and system calls used:
  *   - `timerfd_create`: to create a timer file descriptor.
  *   - `timerfd_settime`: to set the timer's expiration interval.
  */
-static int setup_timer_fd() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static int setup_timer_fd(EvReactor *r) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        perror("timerfd_create");
+        return -1;
+    }
+    r->timer_fd = fd;
+    initialize_timer(r);
+    return fd;
 }
 
 
@@ -535,6 +3220,10 @@ static int setup_timer_fd() {
  *
  * Sets up a server socket file descriptor for listening on the specified port.
  *
+ * With reuse_port set, SO_REUSEPORT lets every reactor bind its own socket to the port,
+ * and the kernel spreads new connections across them. The socket profile from
+ * socket_tuning.h is applied before listen(), and sets the backlog.
+ *
  * Implementation hints:
  *   1. Create a socket and set the socket options to allow address reuse and non-blocking mode.
  *   2. Bind the socket to the specified port and address and listen for incoming connections.
@@ -542,18 +3231,40 @@ static int setup_timer_fd() {
  * APIs and system calls that you may need:
  * - Socket operations: socket(), setsockopt(), fcntl(), bind(), listen()
  */
-static int setup_server_fd(int port) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static int setup_server_fd(int port, int reuse_port) {
+    int server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    int opt = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt");
+        close(server_fd);
+        return -1;
+    }
+    if (reuse_port && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT");
+        close(server_fd);
+        return -1;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        perror("bind");
+        close(server_fd);
+        return -1;
+    }
+    socket_tune_listener(server_fd, 0);
+    if (listen(server_fd, socket_tuning_backlog()) < 0) {
+        perror("listen");
+        close(server_fd);
+        return -1;
+    }
+    return server_fd;
 }
 
 /**
@@ -565,6 +3276,8 @@ static int setup_server_fd(int port) {
  *  |_|  |_| M4
  *
  * Sets up an epoll file descriptor and adds the server and timer file descriptors to it.
+ * server_events adds EPOLLET and, on a listening socket shared by several reactors,
+ * EPOLLEXCLUSIVE, so a new connection wakes one reactor instead of all of them.
  *
  * Implementation hints:
  *   1. Create an epoll instance using and initialize an epoll event structure for the server socket.
@@ -575,18 +3288,69 @@ static int setup_server_fd(int port) {
  * APIs and system calls that you may need:
  * - Epoll operations: epoll_create1(), epoll_ctl()
  */
-static int setup_epoll_fd(int server_fd, int timer_fd, struct epoll_event *ev, struct epoll_event *events) {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+static int setup_epoll_fd(int server_fd, uint32_t server_events, int timer_fd, struct epoll_event *ev, struct epoll_event *events) {
+    (void)events;
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        return -1;
+    }
+    ev->events = server_events;
+    ev->data.fd = server_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, ev) < 0) {
+        perror("epoll_ctl server");
+        close(epoll_fd);
+        return -1;
+    }
+    ev->events = EPOLLIN;
+    ev->data.fd = timer_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, ev) < 0) {
+        perror("epoll_ctl timer");
+        close(epoll_fd);
+        return -1;
+    }
+    return epoll_fd;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Sets up the reactor's io_uring and its recv buffer ring.  *
+  * Returns -1 with errno set if the kernel cannot provide    *
+  * them (provided-buffer rings need Linux 5.19).             *
+  *************************************************************
+*/
+static int setup_uring(EvReactor *r) {
+    Uring *ring = malloc(sizeof(Uring));
+    if (!ring) return -1;
+    if (uring_init(ring, URING_ENTRIES) < 0) {
+        free(ring);
+        return -1;
+    }
+    if (uring_buf_ring_init(ring, &r->recv_bufs, URING_RECV_BUFFERS, URING_RECV_BUFFER_SIZE, URING_BUFFER_GROUP) < 0) {
+        int saved = errno;
+        uring_exit(ring);
+        free(ring);
+        errno = saved;
+        return -1;
+    }
+    r->ring = ring;
+    return 0;
+}
+
+static void teardown_uring(EvReactor *r) {
+    if (!r->ring) return;
+    uring_buf_ring_free(r->ring, &r->recv_bufs);
+    uring_exit(r->ring);
+    free(r->ring);
+    r->ring = NULL;
 }
 
 /*
@@ -602,28 +3366,253 @@ static int setup_epoll_fd(int server_fd, int timer_fd, struct epoll_event *ev, s
   * Main event loop                                           *
   *************************************************************
 */
-static void event_loop(V8Engine *engine, int server_fd, int timer_fd, int epoll_fd, struct epoll_event *ev, struct epoll_event *events) {
+static void event_loop(EvReactor *r, struct epoll_event *events) {
     while (server_running_eb) {
-        int nfds = epoll_wait(epoll_fd, events, MAX_EVENTS, 1000);
+        // with work still pending, only poll so the backlog keeps draining
+        int busy = dispatch_ready(r) || r->accept_pending || r->ready_head >= 0;
+        int nfds = epoll_wait(r->epoll_fd, events, r->max_events, busy ? 0 : 1000);
+        r->now = monotonic_ms();
         if (nfds == -1) {
             if (!server_running_eb) break;
             perror("epoll_wait");
             continue;
         }
+        // a full batch means more events were waiting: take twice as many next time
+        if (nfds == r->max_events && r->max_events < MAX_EVENTS) r->max_events *= 2;
+        else if (nfds < r->max_events / 4 && r->max_events > MIN_EVENTS) r->max_events /= 2;
         for (int n = 0; n < nfds; ++n) {
-            if (events[n].data.fd == timer_fd) {
-                handle_timer_event(engine);
+            int fd = events[n].data.fd;
+            uint32_t mask = events[n].events;
+            if (fd == r->timer_fd) {
+                handle_timer_event(r);
                 continue;
             }
-            if (events[n].data.fd == server_fd) {
-                handle_new_connection(server_fd, epoll_fd, ev);
-            } else {
-                handle_client_event(engine, events[n].data.fd, ev, epoll_fd);
+            if (fd == r->compress_done.event_fd) {
+                handle_compress_event(r);
+                continue;
+            }
+            if (fd == r->handler_done.event_fd) {
+                handle_handler_event(r);
+                continue;
+            }
+            if (fd == r->fs_done.event_fd) {
+                handle_fs_event(r);
+                continue;
+            }
+            if (fd == r->server_fd) {
+                r->accept_pending = 1;
+                continue;
             }
+            EvConn *c = &r->conns[fd];
+            if (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) c->readable = 1;
+            if ((mask & (EPOLLOUT | EPOLLERR)) && c->out_bytes) {
+                if (flush_output(r, fd) < 0) continue;
+                conn_resume(r, fd);
+            }
+            if (c->open && c->readable && conn_wants_input(c)) handle_client_event(r, fd);
+        }
+        if (r->accept_pending) handle_new_connection(r);
+        drain_ready(r);
+        dispatch_pending(r);
+        // new connections may have brought the next deadline forward
+        initialize_timer(r);
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Main event loop on io_uring. One io_uring_enter submits   *
+  * the recvs and sends queued since the last one and waits   *
+  * for completions, which replaces the epoll_wait, read and  *
+  * write calls of the epoll loop.                            *
+  *************************************************************
+*/
+static void uring_event_loop(EvReactor *r) {
+    uring_arm_accept(r);
+    uring_arm_timer(r);
+    uring_arm_wake(r, r->compress_done.event_fd);
+    uring_arm_wake(r, r->handler_done.event_fd);
+    uring_arm_wake(r, r->fs_done.event_fd);
+    while (server_running_eb) {
+        // with requests still queued, only submit so the backlog keeps draining
+        int timeout = dispatch_ready(r) ? 0 : 1000;
+        int rc = uring_submit_and_wait(r->ring, timeout ? 1 : 0, timeout);
+        r->now = monotonic_ms();
+        if (rc < 0) {
+            if (!server_running_eb) break;
+            perror("io_uring_enter");
+            continue;
+        }
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(r->ring))) {
+            // release the slot first, handlers may submit and complete more work
+            struct io_uring_cqe completion = *cqe;
+            uring_cqe_seen(r->ring);
+            uring_handle_completion(r, &completion);
+        }
+        dispatch_pending(r);
+        initialize_timer(r);
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Runs one reactor to completion on the calling thread.     *
+  * Reactor 0 uses the startup isolate; every other reactor   *
+  * loads the app script into an isolate of its own first.    *
+  *************************************************************
+*/
+static int run_reactor(EvReactor *r) {
+    EvServer *server = r->server;
+    current_reactor = r;
+    if (r->index == 0) {
+        r->engine = server->engine;
+        r->timers = ev_timers_get(NULL);
+    } else {
+        // bind first so the isolate heap is allocated on the reactor's node
+        affinity_bind_thread(r->index, "reactor");
+        // the app script's timer calls need the table before it runs
+        r->timers = malloc(sizeof(EvTimers));
+        if (!r->timers) return 1;
+        ev_timers_init(r->timers);
+        r->engine = v8_create_isolate(server->engine);
+        if (!r->engine) {
+            fprintf(stderr, "Reactor %d: could not load the app script\n", r->index);
+            // the isolate is gone, so its callback handles cannot be released
+            ev_timers_destroy(r->timers, 0);
+            free(r->timers);
+            current_reactor = NULL;
+            return 1;
+        }
+    }
+    int rc = 1;
+    struct rlimit rl;
+    r->max_conns = getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY ? (int)rl.rlim_cur : 65536;
+    // reserved up front and touched lazily: a slot costs memory once its fd is first used
+    r->conns = mmap(NULL, (size_t)r->max_conns * sizeof(EvConn), PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (r->conns == MAP_FAILED) r->conns = NULL;
+    r->dispatch_queue = fair_queue_create(server->fair_quantum);
+    r->static_cache = static_file_cache_create(STATIC_CACHE_FILES);
+    if (!r->conns || !r->dispatch_queue || !r->static_cache || setup_timer_fd(r) == -1 ||
+        job_completions_init(&r->compress_done) < 0 || job_completions_init(&r->handler_done) < 0 ||
+        job_completions_init(&r->fs_done) < 0) {
+        goto out;
+    }
+    r->now = monotonic_ms();
+    timer_entry_init(&r->date_tick, date_tick, r);
+    date_tick(&r->date_tick, r);
+    r->server_fd = server->shared_fd >= 0 ? server->shared_fd : setup_server_fd(server->port, server->num_reactors > 1);
+    if (r->server_fd == -1) goto out;
+    if (server->use_uring) {
+        if (setup_uring(r) == 0) {
+            uring_event_loop(r);
+            rc = 0;
+            goto out;
         }
+        fprintf(stderr, "Reactor %d: io_uring unavailable (%s), falling back to epoll\n", r->index, strerror(errno));
+    }
+    uint32_t server_events = EPOLLIN;
+    if (server->edge_triggered) server_events |= EPOLLET;
+    if (server->shared_fd >= 0 && server->num_reactors > 1) server_events |= EPOLLEXCLUSIVE;
+    struct epoll_event ev, events[MAX_EVENTS];
+    r->epoll_fd = setup_epoll_fd(r->server_fd, server_events, r->timer_fd, &ev, events);
+    if (r->epoll_fd == -1) goto out;
+    ev.events = EPOLLIN;
+    ev.data.fd = r->compress_done.event_fd;
+    if (epoll_ctl(r->epoll_fd, EPOLL_CTL_ADD, r->compress_done.event_fd, &ev) < 0) {
+        perror("epoll_ctl eventfd");
+        goto out;
+    }
+    ev.data.fd = r->handler_done.event_fd;
+    if (epoll_ctl(r->epoll_fd, EPOLL_CTL_ADD, r->handler_done.event_fd, &ev) < 0) {
+        perror("epoll_ctl eventfd");
+        goto out;
+    }
+    ev.data.fd = r->fs_done.event_fd;
+    if (epoll_ctl(r->epoll_fd, EPOLL_CTL_ADD, r->fs_done.event_fd, &ev) < 0) {
+        perror("epoll_ctl eventfd");
+        goto out;
+    }
+    event_loop(r, events);
+    rc = 0;
+out:
+    if (r->timer_fd != -1) close(r->timer_fd);
+    if (r->server_fd != -1 && r->server_fd != server->shared_fd) close(r->server_fd);
+    if (r->epoll_fd != -1) close(r->epoll_fd);
+    fair_queue_destroy(r->dispatch_queue);
+    r->dispatch_queue = NULL;
+    for (int fd = 0; r->conns && fd < r->max_conns; fd++) close_client(r, fd);
+    // requests still on the handler workers come back to connections that are gone now
+    while (r->handler_inflight > 0) {
+        struct pollfd pfd = { .fd = r->handler_done.event_fd, .events = POLLIN };
+        poll(&pfd, 1, 100);
+        handle_handler_event(r);
+    }
+    job_completions_destroy(&r->handler_done);
+    // jobs still in the pool point at this reactor; with the connections gone they only need freeing
+    while (r->compress_inflight > 0) {
+        struct pollfd pfd = { .fd = r->compress_done.event_fd, .events = POLLIN };
+        poll(&pfd, 1, 100);
+        handle_compress_event(r);
+    }
+    job_completions_destroy(&r->compress_done);
+    // fs calls still in the pool hold Promises of this reactor's isolate, released before it goes
+    while (r->fs_inflight > 0) {
+        struct pollfd pfd = { .fd = r->fs_done.event_fd, .events = POLLIN };
+        poll(&pfd, 1, 100);
+        handle_fs_event(r);
+    }
+    job_completions_destroy(&r->fs_done);
+    teardown_uring(r);
+    static_file_cache_destroy(r->static_cache);
+    r->static_cache = NULL;
+    if (r->conns) munmap(r->conns, (size_t)r->max_conns * sizeof(EvConn));
+    r->conns = NULL;
+    while (r->free_requests) {
+        EvPendingRequest *pending = r->free_requests;
+        r->free_requests = pending->next;
+        free(pending->arena.data);
+        free(pending);
     }
+    while (r->free_chunks) {
+        EvOutChunk *chunk = r->free_chunks;
+        r->free_chunks = chunk->next;
+        free(chunk);
+    }
+    buffer_pool_thread_cleanup();
+    http_compress_thread_cleanup();
+    timer_wheel_cancel(&r->timers->wheel, &r->date_tick);
+    ev_timers_destroy(r->timers, 1);
+    if (r->index != 0) {
+        free(r->timers);
+        v8_dispose_isolate(r->engine);
+    }
+    r->timers = NULL;
+    current_reactor = NULL;
+    return rc;
 }
 
+static void *reactor_thread(void *arg) {
+    run_reactor(arg);
+    return NULL;
+}
 
 /*
   *************************************************************
@@ -635,23 +3624,111 @@ static void event_loop(V8Engine *engine, int server_fd, int timer_fd, int epoll_
   *   ██║  ██║███████║██║                                     *
   *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
   *                                                           *
-  * Server startup                                            *
+  * Server startup. ASP_REACTORS picks the number of          *
+  * shared-nothing reactors, 0 means one per online CPU.      *
+  * ASP_IO_BACKEND picks epoll or io_uring, ASP_EPOLL_MODE    *
+  * level- or edge-triggered epoll, and ASP_REACTOR_LISTEN    *
+  * one socket per reactor or a single shared one.            *
+  * ASP_RESPONSE_CACHE_MB sizes the shared response cache,    *
+  * ASP_COMPRESS_* set up response compression,               *
+  * ASP_HANDLER_THREADS moves JS handlers onto worker         *
+  * isolates, and ASP_FS_THREADS sizes the pool behind        *
+  * ASP.fs.                                                   *
+  * Reactor 0 runs on the calling thread.                     *
   *************************************************************
 */
 int start_server_eb(V8Engine *engine, int port) {
     telemetry_init();
-    timer_fd = setup_timer_fd();
-    if (timer_fd == -1) return 1;
-    int server_fd = setup_server_fd(port);
-    server_fd_global_eb = server_fd;
-    if (server_fd < 0) return 1;
-    struct epoll_event ev, events[MAX_EVENTS];
-    int epoll_fd = setup_epoll_fd(server_fd, timer_fd, &ev, events);
-    if (epoll_fd == -1) return 1;
-    event_loop(engine, server_fd, timer_fd, epoll_fd, &ev, events);
-    if (timer_fd != -1) close(timer_fd);
-    if (server_fd != -1) close(server_fd);
-    if (epoll_fd != -1) close(epoll_fd);
+    EvServer server = {
+        .engine = engine,
+        .port = port,
+        .fair_quantum = config_get_int("ASP_FAIR_QUANTUM", DEFAULT_FAIR_QUANTUM),
+        .num_reactors = config_get_int("ASP_REACTORS", DEFAULT_REACTORS),
+        .keep_alive_timeout = config_get_int("ASP_KEEPALIVE_TIMEOUT", DEFAULT_KEEP_ALIVE_TIMEOUT),
+        .keep_alive_max = config_get_int("ASP_KEEPALIVE_MAX", DEFAULT_KEEP_ALIVE_MAX),
+    };
+    if (server.keep_alive_max <= 1) server.keep_alive_timeout = 0;
+    int cache_mb = config_get_int("ASP_RESPONSE_CACHE_MB", DEFAULT_RESPONSE_CACHE_MB);
+    response_cache_init(cache_mb > 0 ? (size_t)cache_mb << 20 : 0);
+    compress_min_bytes = config_get_int("ASP_COMPRESS_MIN_BYTES", DEFAULT_COMPRESS_MIN_BYTES);
+    if (compress_min_bytes > 0) {
+        http_compress_set_level(config_get_int("ASP_COMPRESS_LEVEL", DEFAULT_COMPRESS_LEVEL));
+        // without a pool every body is compressed on its reactor
+        if (compress_pool_start(config_get_int("ASP_COMPRESS_THREADS", DEFAULT_COMPRESS_THREADS)) < 0) {
+            fprintf(stderr, "Could not start the compression pool, compressing on the reactors\n");
+        }
+    }
+    const char *fair_key = config_get_string("ASP_FAIR_KEY", "peer");
+    server.fair_by_peer = strcmp(fair_key, "none") != 0;
+    if (strncmp(fair_key, "header:", 7) == 0 && fair_key[7]) server.fair_header = fair_key + 7;
+    if (server.num_reactors <= 0) server.num_reactors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (server.num_reactors <= 0) server.num_reactors = 1;
+    server.use_uring = strcmp(config_get_string("ASP_IO_BACKEND", "epoll"), "io_uring") == 0;
+    const char *epoll_mode = config_get_string("ASP_EPOLL_MODE", "level");
+    server.edge_triggered = strcmp(epoll_mode, "edge") == 0;
+    if (!server.edge_triggered && strcmp(epoll_mode, "level") != 0) {
+        fprintf(stderr, "Unknown ASP_EPOLL_MODE '%s', using 'level'\n", epoll_mode);
+    }
+    server.shared_fd = -1;
+    const char *listen_mode = config_get_string("ASP_REACTOR_LISTEN", "reuseport");
+    if (strcmp(listen_mode, "shared") == 0) {
+        server.shared_fd = setup_server_fd(port, 0);
+        if (server.shared_fd == -1) return 1;
+    } else if (strcmp(listen_mode, "reuseport") != 0) {
+        fprintf(stderr, "Unknown ASP_REACTOR_LISTEN '%s', using 'reuseport'\n", listen_mode);
+    }
+    server.reactors = calloc(server.num_reactors, sizeof(EvReactor));
+    if (!server.reactors) {
+        if (server.shared_fd != -1) close(server.shared_fd);
+        return 1;
+    }
+    for (int i = 0; i < server.num_reactors; i++) {
+        EvReactor *r = &server.reactors[i];
+        r->server = &server;
+        r->index = i;
+        r->server_fd = r->epoll_fd = r->timer_fd = -1;
+        r->compress_done.event_fd = -1;
+        r->handler_done.event_fd = -1;
+        r->fs_done.event_fd = -1;
+        r->ready_head = r->ready_tail = -1;
+        r->idle_head = r->idle_tail = -1;
+        r->max_events = MIN_EVENTS;
+        r->timer_armed = UINT64_MAX;
+    }
+    // without a pool ASP.fs calls block the reactor that makes them
+    if (fs_pool_start(config_get_int("ASP_FS_THREADS", DEFAULT_FS_THREADS)) < 0) {
+        fprintf(stderr, "Could not start the fs pool, running ASP.fs calls on the reactors\n");
+    }
+    int handler_threads = config_get_int("ASP_HANDLER_THREADS", DEFAULT_HANDLER_THREADS);
+    if (handler_threads > 0) {
+        // the workers take the cpus after the reactors'
+        int workers = isolate_pool_start(engine, handler_threads, server.num_reactors);
+        if (workers > 0) {
+            server.handler_window = workers * HANDLER_WINDOW;
+            printf("Handlers: %d worker isolate(s)\n", workers);
+        } else {
+            fprintf(stderr, "Could not start the handler workers, running handlers on the reactors\n");
+        }
+    }
+    printf("Event loop: %d reactor(s), %s, %s\n", server.num_reactors,
+           server.use_uring ? "io_uring" : server.edge_triggered ? "epoll edge-triggered" : "epoll level-triggered",
+           server.shared_fd != -1 ? "shared listening socket" : "SO_REUSEPORT listening sockets");
+    int started = 1;
+    for (; started < server.num_reactors; started++) {
+        if (pthread_create(&server.reactors[started].thread, NULL, reactor_thread, &server.reactors[started]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+    }
+    int rc = run_reactor(&server.reactors[0]);
+    // a reactor only returns once the server stops, so the rest are shutting down too
+    server_running_eb = 0;
+    for (int i = 1; i < started; i++) pthread_join(server.reactors[i].thread, NULL);
+    isolate_pool_stop();
+    fs_pool_stop();
+    compress_pool_stop();
+    if (server.shared_fd != -1) close(server.shared_fd);
+    free(server.reactors);
     printf("Event-based server stopped.\n");
-    return 0;
+    return rc;
 }
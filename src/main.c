@@ -27,6 +27,8 @@
 #include <unistd.h>
 #include <bits/signum-generic.h>
 
+#include "affinity.h"
+#include "socket_tuning.h"
 #include "utils.h"
 
 /*
@@ -92,6 +94,10 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Usage: %s <script.js>\n", argv[0]);
         return 1;
     }
+    // pin before V8 starts so the isolate heap is allocated on the main thread's node
+    affinity_init();
+    socket_tuning_init();
+    affinity_bind_thread(0, "main");
     V8Engine *engine = v8_initialize(argc, argv);
     if (!engine) {
         fprintf(stderr, "Failed to initialize V8\n");
@@ -0,0 +1,443 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "response_cache.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define RESPONSE_CACHE_BUCKETS 1024
+// a refresh that has not stored anything by then is assumed lost, and another request may try
+#define RESPONSE_CACHE_REVALIDATE_MS 10000
+
+typedef struct ResponseCacheShard {
+    pthread_mutex_t lock;
+    ResponseCacheEntry *buckets[RESPONSE_CACHE_BUCKETS];
+    // most recently used first; the tail is dropped when the shard is over budget
+    ResponseCacheEntry *lru_head, *lru_tail;
+    size_t bytes;
+} ResponseCacheShard;
+
+static ResponseCacheShard shards[RESPONSE_CACHE_SHARDS];
+// written once before the reactors start, 0 while the cache is off
+static size_t shard_budget = 0;
+
+static unsigned hash_path(const char *path) {
+    unsigned hash = 2166136261u;
+    for (; *path; path++) {
+        hash ^= (unsigned char)*path;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ResponseCacheShard *shard_for(unsigned hash) {
+    return &shards[(hash >> 24) % RESPONSE_CACHE_SHARDS];
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Sets the total byte budget, split evenly over the shards. *
+  * 0 leaves the cache off. Called once, before any lookup.   *
+  *************************************************************
+*/
+void response_cache_init(size_t budget_bytes) {
+    for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++) pthread_mutex_init(&shards[i].lock, NULL);
+    shard_budget = budget_bytes / RESPONSE_CACHE_SHARDS;
+}
+
+int response_cache_enabled(void) {
+    return shard_budget > 0;
+}
+
+void response_cache_release(ResponseCacheEntry *entry) {
+    if (atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) != 1) return;
+    free(entry->method);
+    free(entry->path);
+    for (int i = 0; i < entry->vary_count; i++) {
+        free(entry->vary_names[i]);
+        free(entry->vary_values[i]);
+    }
+    free(entry->content_type);
+    free(entry->cache_control);
+    free(entry->vary);
+    free(entry->etag);
+    free(entry->body);
+    for (int i = 0; i < HTTP_ENCODING_COUNT; i++) free(atomic_load(&entry->encoded[i]));
+    free(entry);
+}
+
+static void lru_unlink(ResponseCacheShard *shard, ResponseCacheEntry *entry) {
+    if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else shard->lru_head = entry->lru_next;
+    if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else shard->lru_tail = entry->lru_prev;
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void lru_push_front(ResponseCacheShard *shard, ResponseCacheEntry *entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = shard->lru_head;
+    if (shard->lru_head) shard->lru_head->lru_prev = entry;
+    else shard->lru_tail = entry;
+    shard->lru_head = entry;
+}
+
+/* Takes the entry out of its shard and drops the cache's reference. Caller holds the lock. */
+static void uncache(ResponseCacheShard *shard, ResponseCacheEntry *entry) {
+    ResponseCacheEntry **link = &shard->buckets[entry->hash % RESPONSE_CACHE_BUCKETS];
+    while (*link != entry) link = &(*link)->hash_next;
+    *link = entry->hash_next;
+    lru_unlink(shard, entry);
+    shard->bytes -= entry->cost;
+    entry->cached = 0;
+    response_cache_release(entry);
+}
+
+static int same_value(const char *a, const char *b) {
+    if (!a || !b) return a == b;
+    return strcmp(a, b) == 0;
+}
+
+/* Whether a cached entry answers this request, Vary headers included. */
+static int entry_matches(const ResponseCacheEntry *entry, unsigned hash, const char *method, const char *path,
+                         ResponseCacheHeaderFn header, const void *request) {
+    if (entry->hash != hash || strcmp(entry->method, method) != 0 || strcmp(entry->path, path) != 0) return 0;
+    for (int i = 0; i < entry->vary_count; i++) {
+        if (!same_value(entry->vary_values[i], header(request, entry->vary_names[i]))) return 0;
+    }
+    return 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Finds the response for a request. A stale entry inside    *
+  * its stale-while-revalidate window is handed to the first  *
+  * caller that may refresh it as REVALIDATE, and to everyone *
+  * else as STALE until the refresh is stored. Callers that   *
+  * may not refresh see such an entry as a miss.              *
+  *************************************************************
+*/
+ResponseCacheResult response_cache_lookup(const char *method, const char *path, ResponseCacheHeaderFn header,
+                                          const void *request, long long now_ms, int may_revalidate,
+                                          ResponseCacheEntry **out) {
+    *out = NULL;
+    if (!shard_budget) return RESPONSE_CACHE_MISS;
+    unsigned hash = hash_path(path);
+    ResponseCacheShard *shard = shard_for(hash);
+    pthread_mutex_lock(&shard->lock);
+    ResponseCacheEntry *entry = shard->buckets[hash % RESPONSE_CACHE_BUCKETS];
+    while (entry && !entry_matches(entry, hash, method, path, header, request)) entry = entry->hash_next;
+    ResponseCacheResult result = RESPONSE_CACHE_MISS;
+    if (!entry) {
+        // nothing cached
+    } else if (now_ms < entry->fresh_until_ms) {
+        result = RESPONSE_CACHE_FRESH;
+    } else if (now_ms >= entry->stale_until_ms) {
+        uncache(shard, entry);
+    } else if (entry->revalidating_ms && now_ms - entry->revalidating_ms < RESPONSE_CACHE_REVALIDATE_MS) {
+        result = RESPONSE_CACHE_STALE;
+    } else if (may_revalidate) {
+        entry->revalidating_ms = now_ms;
+        result = RESPONSE_CACHE_REVALIDATE;
+    }
+    if (result != RESPONSE_CACHE_MISS) {
+        lru_unlink(shard, entry);
+        lru_push_front(shard, entry);
+        atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+        *out = entry;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return result;
+}
+
+/*
+ * Value of a Cache-Control directive: -1 if it is absent, 0 for a directive without a value.
+ * Directive names are case-insensitive and delimited by commas.
+ */
+static long directive_value(const char *cache_control, const char *name) {
+    size_t name_len = strlen(name);
+    const char *p = cache_control;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        const char *token = p;
+        while (*p && *p != ',' && *p != '=' && *p != ' ') p++;
+        int match = (size_t)(p - token) == name_len && strncasecmp(token, name, name_len) == 0;
+        while (*p == ' ') p++;
+        long value = 0;
+        if (*p == '=') {
+            p++;
+            if (*p == '"') p++;
+            value = strtol(p, NULL, 10);
+        }
+        if (match) return value < 0 ? 0 : value;
+        while (*p && *p != ',') p++;
+    }
+    return -1;
+}
+
+/* Statuses that may be cached when the handler asks for it (RFC 9110, section 15.1). */
+static int status_cacheable(int status) {
+    switch (status) {
+        case 200: case 203: case 204: case 300: case 301: case 308:
+        case 404: case 405: case 410: case 414: case 501:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Builds an entry for a handler response, or returns NULL   *
+  * if the response does not allow caching: no max-age,       *
+  * no-store, no-cache or private, Vary: *, or too large.     *
+  *************************************************************
+*/
+static ResponseCacheEntry *create_entry(unsigned hash, const char *method, const char *path,
+                                        ResponseCacheHeaderFn header, const void *request, long long now_ms,
+                                        int status, const char *content_type, const char *body, size_t body_len,
+                                        const char *cache_control, const char *vary, const char *etag) {
+    if (!cache_control || !status_cacheable(status)) return NULL;
+    if (directive_value(cache_control, "no-store") >= 0 || directive_value(cache_control, "no-cache") >= 0 ||
+        directive_value(cache_control, "private") >= 0) {
+        return NULL;
+    }
+    long max_age = directive_value(cache_control, "s-maxage");
+    if (max_age < 0) max_age = directive_value(cache_control, "max-age");
+    if (max_age <= 0) return NULL;
+    long stale = directive_value(cache_control, "stale-while-revalidate");
+
+    ResponseCacheEntry *entry = calloc(1, sizeof(ResponseCacheEntry));
+    if (!entry) return NULL;
+    entry->refs = 1;
+    entry->hash = hash;
+    entry->status = status;
+    entry->stored_ms = now_ms;
+    entry->fresh_until_ms = now_ms + max_age * 1000LL;
+    entry->stale_until_ms = entry->fresh_until_ms + (stale > 0 ? stale * 1000LL : 0);
+    entry->method = strdup(method);
+    entry->path = strdup(path);
+    entry->content_type = content_type ? strdup(content_type) : NULL;
+    entry->cache_control = strdup(cache_control);
+    entry->vary = vary ? strdup(vary) : NULL;
+    entry->etag = etag ? strdup(etag) : NULL;
+    entry->body = malloc(body_len + 1);
+    int ok = entry->method && entry->path && entry->cache_control && entry->body &&
+             (!content_type || entry->content_type) && (!vary || entry->vary) && (!etag || entry->etag);
+    if (entry->body) {
+        memcpy(entry->body, body, body_len);
+        entry->body[body_len] = '\0';
+    }
+    entry->body_len = body_len;
+    entry->cost = sizeof(ResponseCacheEntry) + strlen(method) + strlen(path) + body_len + strlen(cache_control) +
+                  (content_type ? strlen(content_type) : 0) + (vary ? strlen(vary) : 0) + (etag ? strlen(etag) : 0);
+
+    for (const char *p = vary ? vary : ""; ok && *p;) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        const char *name = p;
+        while (*p && *p != ',' && *p != ' ' && *p != '\t') p++;
+        size_t name_len = p - name;
+        if (name_len == 0) continue;
+        // Vary: * means no two requests are alike
+        if ((name_len == 1 && *name == '*') || entry->vary_count == RESPONSE_CACHE_VARY_MAX) {
+            ok = 0;
+            break;
+        }
+        char *copy = strndup(name, name_len);
+        const char *value = copy ? header(request, copy) : NULL;
+        entry->vary_names[entry->vary_count] = copy;
+        entry->vary_values[entry->vary_count] = value ? strdup(value) : NULL;
+        entry->vary_count++;
+        ok = copy && (!value || entry->vary_values[entry->vary_count - 1]);
+        entry->cost += name_len + (value ? strlen(value) : 0);
+    }
+    if (!ok || entry->cost > shard_budget) {
+        response_cache_release(entry);
+        return NULL;
+    }
+    return entry;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Records the handler's response to a request. Whatever was *
+  * cached for the request is replaced, or dropped if the new *
+  * response may not be cached, which also ends a refresh.    *
+  * Least recently used entries go when the shard is full.    *
+  * Returns the new entry with a reference for the caller, or *
+  * NULL if nothing was cached.                               *
+  *************************************************************
+*/
+ResponseCacheEntry *response_cache_store(const char *method, const char *path, ResponseCacheHeaderFn header,
+                                         const void *request, long long now_ms, int status, const char *content_type,
+                                         const char *body, size_t body_len, const char *cache_control, const char *vary,
+                                         const char *etag) {
+    if (!shard_budget) return NULL;
+    unsigned hash = hash_path(path);
+    ResponseCacheEntry *fresh = create_entry(hash, method, path, header, request, now_ms, status, content_type,
+                                             body, body_len, cache_control, vary, etag);
+    ResponseCacheShard *shard = shard_for(hash);
+    pthread_mutex_lock(&shard->lock);
+    ResponseCacheEntry **link = &shard->buckets[hash % RESPONSE_CACHE_BUCKETS];
+    while (*link) {
+        ResponseCacheEntry *entry = *link;
+        if (entry_matches(entry, hash, method, path, header, request)) uncache(shard, entry);
+        else link = &entry->hash_next;
+    }
+    if (fresh) {
+        fresh->hash_next = shard->buckets[hash % RESPONSE_CACHE_BUCKETS];
+        shard->buckets[hash % RESPONSE_CACHE_BUCKETS] = fresh;
+        lru_push_front(shard, fresh);
+        shard->bytes += fresh->cost;
+        fresh->cached = 1;
+        // the caller's reference keeps it alive even if it is evicted right away
+        atomic_fetch_add_explicit(&fresh->refs, 1, memory_order_relaxed);
+        while (shard->bytes > shard_budget) uncache(shard, shard->lru_tail);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return fresh;
+}
+
+/* Whether the caller should make this coding of the entry; only the first caller is told to. */
+int response_cache_claim_encoding(ResponseCacheEntry *entry, HttpEncoding encoding) {
+    int bit = 1 << encoding;
+    return !(atomic_fetch_or_explicit(&entry->encoding_claims, bit, memory_order_relaxed) & bit);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Keeps a copy of a compressed body with its entry. NULL    *
+  * data records that the coding does not pay off, so it is   *
+  * not tried again. The copy counts against the shard's      *
+  * budget while the entry is cached.                         *
+  *************************************************************
+*/
+void response_cache_attach_encoded(ResponseCacheEntry *entry, HttpEncoding encoding, const char *data, size_t len) {
+    if (!data) len = 0;
+    ResponseCacheEncoded *encoded = malloc(sizeof(ResponseCacheEncoded) + len);
+    if (!encoded) return;
+    encoded->len = len;
+    if (len) memcpy(encoded->data, data, len);
+    ResponseCacheShard *shard = shard_for(entry->hash);
+    pthread_mutex_lock(&shard->lock);
+    ResponseCacheEncoded *expected = NULL;
+    if (atomic_compare_exchange_strong(&entry->encoded[encoding], &expected, encoded)) {
+        if (entry->cached) {
+            entry->cost += sizeof(ResponseCacheEncoded) + len;
+            shard->bytes += sizeof(ResponseCacheEncoded) + len;
+            // this may evict the entry itself; the caller's reference keeps it valid
+            while (shard->bytes > shard_budget && shard->lru_tail) uncache(shard, shard->lru_tail);
+        }
+    } else {
+        free(encoded);
+    }
+    pthread_mutex_unlock(&shard->lock);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Drops every entry for a path, in all methods and          *
+  * variants. A trailing '*' drops every path with that       *
+  * prefix, and NULL or "" empties the cache. Returns the     *
+  * number of entries dropped.                                *
+  *************************************************************
+*/
+int response_cache_invalidate(const char *path) {
+    if (!shard_budget) return 0;
+    if (!path) path = "";
+    size_t len = strlen(path);
+    int prefix = len == 0 || path[len - 1] == '*';
+    if (prefix && len) len--;
+    unsigned hash = prefix ? 0 : hash_path(path);
+    int dropped = 0;
+    for (int i = 0; i < RESPONSE_CACHE_SHARDS; i++) {
+        ResponseCacheShard *shard = &shards[i];
+        if (!prefix && shard != shard_for(hash)) continue;
+        pthread_mutex_lock(&shard->lock);
+        for (int b = 0; b < RESPONSE_CACHE_BUCKETS; b++) {
+            if (!prefix && b != (int)(hash % RESPONSE_CACHE_BUCKETS)) continue;
+            ResponseCacheEntry **link = &shard->buckets[b];
+            while (*link) {
+                ResponseCacheEntry *entry = *link;
+                int match = prefix ? strncmp(entry->path, path, len) == 0 : strcmp(entry->path, path) == 0;
+                if (match) {
+                    uncache(shard, entry);
+                    dropped++;
+                } else {
+                    link = &entry->hash_next;
+                }
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+    return dropped;
+}
@@ -0,0 +1,172 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "socket_tuning.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "utils.h"
+
+#define DEFAULT_SOCK_BACKLOG SOMAXCONN
+#define DEFAULT_SOCK_NODELAY 1
+
+static SocketTuning tuning = { .backlog = DEFAULT_SOCK_BACKLOG, .nodelay = DEFAULT_SOCK_NODELAY, .defer_accept = -1 };
+
+// what the first listener ended up with, for telemetry
+static SocketTuning effective;
+static int effective_known = 0;
+static pthread_mutex_t effective_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// whether accepted sockets come with the listener's TCP_NODELAY: -1 until the first one is seen
+static atomic_int nodelay_inherited = -1;
+
+void socket_tuning_init(void) {
+    tuning.backlog = config_get_int("ASP_SOCK_BACKLOG", DEFAULT_SOCK_BACKLOG);
+    if (tuning.backlog <= 0) tuning.backlog = DEFAULT_SOCK_BACKLOG;
+    tuning.nodelay = config_get_int("ASP_SOCK_NODELAY", DEFAULT_SOCK_NODELAY) != 0;
+    tuning.defer_accept = config_get_int("ASP_SOCK_DEFER_ACCEPT", -1);
+    tuning.fastopen = config_get_int("ASP_SOCK_FASTOPEN", 0);
+    tuning.busy_poll = config_get_int("ASP_SOCK_BUSY_POLL", 0);
+    tuning.quickack = config_get_int("ASP_SOCK_QUICKACK", 0) != 0;
+    tuning.sndbuf = config_get_int("ASP_SOCK_SNDBUF", 0);
+    tuning.rcvbuf = config_get_int("ASP_SOCK_RCVBUF", 0);
+}
+
+int socket_tuning_backlog(void) {
+    return tuning.backlog;
+}
+
+static void set_option(int fd, int level, int name, int value, const char *label) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) < 0) perror(label);
+}
+
+static int get_option(int fd, int level, int name) {
+    int value = 0;
+    socklen_t len = sizeof(value);
+    return getsockopt(fd, level, name, &value, &len) == 0 ? value : -1;
+}
+
+/* listen() silently caps the backlog at net.core.somaxconn. */
+static int effective_backlog(void) {
+    FILE *f = fopen("/proc/sys/net/core/somaxconn", "r");
+    int max = 0;
+    if (f) {
+        if (fscanf(f, "%d", &max) != 1) max = 0;
+        fclose(f);
+    }
+    return max > 0 && max < tuning.backlog ? max : tuning.backlog;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Tunes a listening socket; called between bind() and       *
+  * listen() so the buffer sizes shape the window scale that  *
+  * accepted connections start with. defer_accept_default is  *
+  * the server's TCP_DEFER_ACCEPT when none is configured. An *
+  * option the kernel refuses is reported and left as it is.  *
+  * The first listener's effective values are printed.        *
+  *************************************************************
+*/
+void socket_tune_listener(int fd, int defer_accept_default) {
+    int defer_accept = tuning.defer_accept >= 0 ? tuning.defer_accept : defer_accept_default;
+    if (tuning.sndbuf > 0) set_option(fd, SOL_SOCKET, SO_SNDBUF, tuning.sndbuf, "setsockopt SO_SNDBUF");
+    if (tuning.rcvbuf > 0) set_option(fd, SOL_SOCKET, SO_RCVBUF, tuning.rcvbuf, "setsockopt SO_RCVBUF");
+    if (tuning.nodelay) set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "setsockopt TCP_NODELAY");
+    if (defer_accept > 0) set_option(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, defer_accept, "setsockopt TCP_DEFER_ACCEPT");
+    if (tuning.fastopen > 0) set_option(fd, IPPROTO_TCP, TCP_FASTOPEN, tuning.fastopen, "setsockopt TCP_FASTOPEN");
+    // raising it above net.core.busy_read needs CAP_NET_ADMIN
+    if (tuning.busy_poll > 0) set_option(fd, SOL_SOCKET, SO_BUSY_POLL, tuning.busy_poll, "setsockopt SO_BUSY_POLL");
+
+    pthread_mutex_lock(&effective_lock);
+    if (!effective_known) {
+        effective = (SocketTuning){
+            .backlog = effective_backlog(),
+            .nodelay = get_option(fd, IPPROTO_TCP, TCP_NODELAY) > 0,
+            .defer_accept = get_option(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT),
+            .fastopen = get_option(fd, IPPROTO_TCP, TCP_FASTOPEN),
+            .busy_poll = get_option(fd, SOL_SOCKET, SO_BUSY_POLL),
+            .quickack = tuning.quickack,
+            // the kernel doubles what was asked for, to leave room for its bookkeeping
+            .sndbuf = get_option(fd, SOL_SOCKET, SO_SNDBUF),
+            .rcvbuf = get_option(fd, SOL_SOCKET, SO_RCVBUF),
+        };
+        effective_known = 1;
+        printf("Socket profile: backlog %d, nodelay %d, defer_accept %ds, fastopen %d, busy_poll %dus, quickack %d, "
+               "sndbuf %d, rcvbuf %d\n",
+               effective.backlog, effective.nodelay, effective.defer_accept, effective.fastopen, effective.busy_poll,
+               effective.quickack, effective.sndbuf, effective.rcvbuf);
+    }
+    pthread_mutex_unlock(&effective_lock);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Tunes a freshly accepted socket. TCP_NODELAY is checked   *
+  * on the first one and set per connection only if it did    *
+  * not come from the listener. TCP_QUICKACK is not sticky:   *
+  * it only covers the ACKs until the kernel falls back to    *
+  * delayed ACKs, which is why it is set on every connection. *
+  *************************************************************
+*/
+void socket_tune_accepted(int fd) {
+    if (tuning.nodelay) {
+        int inherited = atomic_load_explicit(&nodelay_inherited, memory_order_relaxed);
+        if (inherited < 0) {
+            inherited = get_option(fd, IPPROTO_TCP, TCP_NODELAY) > 0;
+            atomic_store_explicit(&nodelay_inherited, inherited, memory_order_relaxed);
+        }
+        if (!inherited) set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "setsockopt TCP_NODELAY");
+    }
+    if (tuning.quickack) set_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "setsockopt TCP_QUICKACK");
+}
+
+/* The effective profile as a JSON object, for telemetry; the configured one before any listener exists. */
+int socket_tuning_describe(char *buf, size_t size) {
+    pthread_mutex_lock(&effective_lock);
+    SocketTuning t = effective_known ? effective : tuning;
+    pthread_mutex_unlock(&effective_lock);
+    return snprintf(buf, size,
+                    "{\"backlog\":%d,\"nodelay\":%d,\"defer_accept\":%d,\"fastopen\":%d,\"busy_poll\":%d,"
+                    "\"quickack\":%d,\"sndbuf\":%d,\"rcvbuf\":%d}",
+                    t.backlog, t.nodelay, t.defer_accept, t.fastopen, t.busy_poll, t.quickack, t.sndbuf, t.rcvbuf);
+}
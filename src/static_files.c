@@ -0,0 +1,433 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "static_files.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define STATIC_PREFIX_MAX 256
+#define STATIC_REVALIDATE_MS 1000
+
+typedef struct StaticRoute {
+    char prefix[STATIC_PREFIX_MAX];
+    size_t prefix_len;
+    char dir[STATIC_PATH_MAX];
+    size_t dir_len;
+} StaticRoute;
+
+// entries are written once, before the count that publishes them
+static StaticRoute routes[STATIC_MAX_ROUTES];
+static atomic_int route_count = 0;
+static pthread_mutex_t route_lock = PTHREAD_MUTEX_INITIALIZER;
+
+struct StaticFileCache {
+    StaticFile **buckets;
+    size_t bucket_count;
+    int count;
+    int capacity;
+    // most recently used first; the tail is closed when the cache is full
+    StaticFile *lru_head, *lru_tail;
+};
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Registers a URL prefix served from a directory. The       *
+  * directory is resolved once, here. Registering the same    *
+  * route again succeeds; a prefix already mapped elsewhere   *
+  * fails with EEXIST.                                        *
+  *************************************************************
+*/
+int static_files_add_route(const char *prefix, const char *dir) {
+    size_t prefix_len = strlen(prefix);
+    if (prefix[0] != '/' || prefix_len >= STATIC_PREFIX_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    // "/assets/" and "/assets" are the same route; "/" stays as it is
+    while (prefix_len > 1 && prefix[prefix_len - 1] == '/') prefix_len--;
+    char resolved[PATH_MAX];
+    struct stat st;
+    if (!realpath(dir, resolved) || stat(resolved, &st) < 0) return -1;
+    if (!S_ISDIR(st.st_mode)) {
+        errno = ENOTDIR;
+        return -1;
+    }
+    if (strlen(resolved) >= STATIC_PATH_MAX) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    pthread_mutex_lock(&route_lock);
+    int count = atomic_load(&route_count);
+    int rc = 0;
+    for (int i = 0; i < count; i++) {
+        if (routes[i].prefix_len == prefix_len && strncmp(routes[i].prefix, prefix, prefix_len) == 0) {
+            if (strcmp(routes[i].dir, resolved) != 0) {
+                errno = EEXIST;
+                rc = -1;
+            }
+            pthread_mutex_unlock(&route_lock);
+            return rc;
+        }
+    }
+    if (count == STATIC_MAX_ROUTES) {
+        errno = ENOSPC;
+        rc = -1;
+    } else {
+        StaticRoute *route = &routes[count];
+        memcpy(route->prefix, prefix, prefix_len);
+        route->prefix[prefix_len] = '\0';
+        route->prefix_len = prefix_len;
+        strcpy(route->dir, resolved);
+        route->dir_len = strlen(resolved);
+        atomic_store_explicit(&route_count, count + 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&route_lock);
+    return rc;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Maps a request path onto the file it names, using the     *
+  * longest matching prefix. The rest of the path is          *
+  * percent-decoded and may not contain a ".." segment or a   *
+  * NUL. A path ending in "/" names its index.html.           *
+  * Returns 1 with the file path in out, 0 if no route        *
+  * matches and -1 if one does but the path is not valid.     *
+  *************************************************************
+*/
+int static_files_resolve(const char *url_path, char *out, size_t out_size) {
+    int count = atomic_load_explicit(&route_count, memory_order_acquire);
+    const StaticRoute *best = NULL;
+    size_t best_len = 0;
+    for (int i = 0; i < count; i++) {
+        const StaticRoute *route = &routes[i];
+        // the root route matches everything; its rest keeps the leading slash
+        size_t len = route->prefix_len == 1 ? 0 : route->prefix_len;
+        if (strncmp(url_path, route->prefix, len) != 0) continue;
+        char next = url_path[len];
+        if (next != '/' && next != '\0' && next != '?') continue;
+        if (!best || len > best_len) {
+            best = route;
+            best_len = len;
+        }
+    }
+    if (!best) return 0;
+
+    if (best->dir_len + 1 >= out_size) return -1;
+    memcpy(out, best->dir, best->dir_len);
+    size_t n = best->dir_len;
+    const char *p = url_path + best_len;
+    if (*p != '/') out[n++] = '/';
+    for (; *p && *p != '?' && *p != '#'; p++) {
+        char c = *p;
+        if (c == '%') {
+            int hi = hex_value(p[1]);
+            int lo = hi < 0 ? -1 : hex_value(p[2]);
+            if (lo < 0) return -1;
+            c = (char)(hi * 16 + lo);
+            p += 2;
+        }
+        if (c == '\0' || n + 1 >= out_size) return -1;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    // out[dir_len] is the slash that starts the part taken from the URL
+    for (const char *seg = out + best->dir_len; seg; seg = strchr(seg + 1, '/')) {
+        if (seg[1] == '.' && seg[2] == '.' && (seg[3] == '/' || seg[3] == '\0')) return -1;
+    }
+    if (out[n - 1] == '/') {
+        static const char index[] = "index.html";
+        if (n + sizeof(index) > out_size) return -1;
+        memcpy(out + n, index, sizeof(index));
+    }
+    return 1;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Content-Type from the file extension                      *
+  *************************************************************
+*/
+static const char *content_type_for(const char *path) {
+    static const struct {
+        const char *ext;
+        const char *type;
+    } types[] = {
+        { "html", "text/html; charset=utf-8" },
+        { "htm", "text/html; charset=utf-8" },
+        { "css", "text/css; charset=utf-8" },
+        { "js", "text/javascript; charset=utf-8" },
+        { "mjs", "text/javascript; charset=utf-8" },
+        { "json", "application/json" },
+        { "map", "application/json" },
+        { "txt", "text/plain; charset=utf-8" },
+        { "xml", "application/xml" },
+        { "svg", "image/svg+xml" },
+        { "png", "image/png" },
+        { "jpg", "image/jpeg" },
+        { "jpeg", "image/jpeg" },
+        { "gif", "image/gif" },
+        { "webp", "image/webp" },
+        { "ico", "image/x-icon" },
+        { "woff", "font/woff" },
+        { "woff2", "font/woff2" },
+        { "wasm", "application/wasm" },
+        { "pdf", "application/pdf" },
+        { "mp4", "video/mp4" },
+    };
+    const char *slash = strrchr(path, '/');
+    const char *dot = strrchr(path, '.');
+    if (dot && (!slash || dot > slash)) {
+        for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+            if (strcasecmp(dot + 1, types[i].ext) == 0) return types[i].type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+static uint32_t hash_path(const char *path) {
+    uint32_t hash = 2166136261u;
+    for (; *path; path++) {
+        hash ^= (unsigned char)*path;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+StaticFileCache *static_file_cache_create(int capacity) {
+    StaticFileCache *cache = calloc(1, sizeof(StaticFileCache));
+    if (!cache) return NULL;
+    cache->capacity = capacity > 0 ? capacity : 1;
+    cache->bucket_count = 16;
+    while (cache->bucket_count < (size_t)cache->capacity) cache->bucket_count *= 2;
+    cache->buckets = calloc(cache->bucket_count, sizeof(StaticFile *));
+    if (!cache->buckets) {
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void static_file_release(StaticFile *file) {
+    if (--file->refs > 0) return;
+    for (int i = 0; i < HTTP_ENCODING_COUNT; i++) free(file->encoded[i]);
+    close(file->fd);
+    free(file->path);
+    free(file);
+}
+
+static void lru_unlink(StaticFileCache *cache, StaticFile *file) {
+    if (file->lru_prev) file->lru_prev->lru_next = file->lru_next;
+    else cache->lru_head = file->lru_next;
+    if (file->lru_next) file->lru_next->lru_prev = file->lru_prev;
+    else cache->lru_tail = file->lru_prev;
+    file->lru_prev = file->lru_next = NULL;
+}
+
+static void lru_push_front(StaticFileCache *cache, StaticFile *file) {
+    file->lru_prev = NULL;
+    file->lru_next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->lru_prev = file;
+    else cache->lru_tail = file;
+    cache->lru_head = file;
+}
+
+/* Drops the cache's reference; queued responses may still hold the file open. */
+static void uncache(StaticFileCache *cache, StaticFile *file) {
+    StaticFile **link = &cache->buckets[hash_path(file->path) & (cache->bucket_count - 1)];
+    while (*link != file) link = &(*link)->hash_next;
+    *link = file->hash_next;
+    lru_unlink(cache, file);
+    file->cached = 0;
+    cache->count--;
+    static_file_release(file);
+}
+
+void static_file_cache_destroy(StaticFileCache *cache) {
+    if (!cache) return;
+    while (cache->lru_head) uncache(cache, cache->lru_head);
+    free(cache->buckets);
+    free(cache);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Returns the open regular file at path with a reference    *
+  * for the caller, from the cache when it is still current.  *
+  * NULL with errno set if it cannot be served; EISDIR for a  *
+  * directory.                                                *
+  *************************************************************
+*/
+StaticFile *static_file_open(StaticFileCache *cache, const char *path, long long now_ms) {
+    size_t bucket = hash_path(path) & (cache->bucket_count - 1);
+    StaticFile *file = cache->buckets[bucket];
+    while (file && strcmp(file->path, path) != 0) file = file->hash_next;
+    if (file && now_ms - file->checked_ms >= STATIC_REVALIDATE_MS) {
+        struct stat st;
+        if (stat(path, &st) == 0 && st.st_ino == file->ino && st.st_dev == file->dev &&
+            st.st_size == file->size && st.st_mtime == file->mtime) {
+            file->checked_ms = now_ms;
+        } else {
+            // replaced, changed or gone: open it again
+            uncache(cache, file);
+            file = NULL;
+        }
+    }
+    if (file) {
+        lru_unlink(cache, file);
+        lru_push_front(cache, file);
+        file->refs++;
+        return file;
+    }
+
+    // O_NONBLOCK so a FIFO cannot hold up the reactor waiting for a writer; regular files ignore it
+    int fd = open(path, O_RDONLY | O_CLOEXEC | O_NONBLOCK | O_NOCTTY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    int ok = fstat(fd, &st) == 0;
+    if (!ok || !S_ISREG(st.st_mode)) {
+        int err = ok && S_ISDIR(st.st_mode) ? EISDIR : EACCES;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    file = calloc(1, sizeof(StaticFile));
+    char *copy = file ? strdup(path) : NULL;
+    if (!copy) {
+        free(file);
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
+    }
+    file->fd = fd;
+    file->size = st.st_size;
+    file->mtime = st.st_mtime;
+    file->dev = st.st_dev;
+    file->ino = st.st_ino;
+    file->content_type = content_type_for(path);
+    file->path = copy;
+    file->checked_ms = now_ms;
+    file->refs = 2;  // the cache's and the caller's
+    file->cached = 1;
+    file->hash_next = cache->buckets[bucket];
+    cache->buckets[bucket] = file;
+    lru_push_front(cache, file);
+    if (++cache->count > cache->capacity) uncache(cache, cache->lru_tail);
+    return file;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Parses a single-range "bytes=" Range header against the   *
+  * file size. Returns 1 with the range set, -1 if it cannot  *
+  * be satisfied (416) and 0 to serve the whole file: no      *
+  * header, another unit, several ranges or a malformed one.  *
+  *************************************************************
+*/
+int static_file_parse_range(const char *header, off_t size, off_t *start, off_t *length) {
+    if (!header || strncasecmp(header, "bytes=", 6) != 0) return 0;
+    const char *p = header + 6;
+    while (*p == ' ') p++;
+    if (strchr(p, ',')) return 0;
+    char *end;
+    if (*p == '-') {
+        // the last n bytes
+        long long n = strtoll(p + 1, &end, 10);
+        if (end == p + 1 || *end || n < 0) return 0;
+        if (n == 0 || size == 0) return -1;
+        *start = n < size ? size - n : 0;
+        *length = size - *start;
+        return 1;
+    }
+    if (*p < '0' || *p > '9') return 0;
+    long long first = strtoll(p, &end, 10);
+    if (*end != '-') return 0;
+    p = end + 1;
+    long long last = size - 1;
+    if (*p) {
+        if (*p < '0' || *p > '9') return 0;
+        last = strtoll(p, &end, 10);
+        if (*end || last < first) return 0;
+    }
+    if (first >= size) return -1;
+    if (last >= size) last = size - 1;
+    *start = first;
+    *length = last - first + 1;
+    return 1;
+}
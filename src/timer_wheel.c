@@ -0,0 +1,218 @@
+/**
+* The MIT License (MIT)
+*
+* Copyright © 2025 <The VU Amsterdam ASP teaching team>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute,
+* sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL <The VU Amsterdam ASP teaching team> BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "timer_wheel.h"
+
+#include <string.h>
+
+#define LEVEL_SHIFT(level) ((level) * TIMER_WHEEL_BITS)
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define MAX_DELTA ((UINT64_C(1) << LEVEL_SHIFT(TIMER_WHEEL_LEVELS)) - 1)
+
+static void list_init(TimerEntry *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) list_init(&wheel->slots[level][slot]);
+    }
+}
+
+void timer_entry_init(TimerEntry *timer, TimerCallback callback, void *arg) {
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+int timer_entry_pending(const TimerEntry *timer) {
+    return timer->prev != NULL;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Files a timer under the lowest level whose span covers    *
+  * its distance from now. Its slot is picked by absolute     *
+  * tick, so the slot stays right as the wheel turns.         *
+  *************************************************************
+*/
+static void wheel_insert(TimerWheel *wheel, TimerEntry *timer) {
+    uint64_t delta = timer->expires - wheel->now;
+    if (delta > MAX_DELTA) {
+        delta = MAX_DELTA;
+        timer->expires = wheel->now + MAX_DELTA;
+    }
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && (delta >> LEVEL_SHIFT(level + 1))) level++;
+    unsigned slot = (timer->expires >> LEVEL_SHIFT(level)) & SLOT_MASK;
+    TimerEntry *head = &wheel->slots[level][slot];
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+    wheel->occupied[level][slot / 64] |= UINT64_C(1) << (slot % 64);
+    wheel->count++;
+}
+
+static void wheel_unlink(TimerWheel *wheel, TimerEntry *timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+    TimerEntry *head = &wheel->slots[timer->level][timer->slot];
+    if (head->next == head) wheel->occupied[timer->level][timer->slot / 64] &= ~(UINT64_C(1) << (timer->slot % 64));
+    wheel->count--;
+}
+
+/* Schedules the timer for tick `expires`, moving it if it was already scheduled. */
+void timer_wheel_add(TimerWheel *wheel, TimerEntry *timer, uint64_t expires) {
+    if (timer->prev) wheel_unlink(wheel, timer);
+    // the current tick has been processed already; a timer that is due now fires on the next one
+    timer->expires = expires > wheel->now ? expires : wheel->now + 1;
+    wheel_insert(wheel, timer);
+}
+
+void timer_wheel_cancel(TimerWheel *wheel, TimerEntry *timer) {
+    if (timer->prev) wheel_unlink(wheel, timer);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Distance from start to the first occupied slot of a       *
+  * level, wrapping around, or -1 if the level is empty       *
+  *************************************************************
+*/
+static int next_occupied(const uint64_t *bits, unsigned start) {
+    for (unsigned i = 0; i < TIMER_WHEEL_SLOTS;) {
+        unsigned slot = (start + i) & SLOT_MASK;
+        uint64_t word = bits[slot / 64] >> (slot % 64);
+        if (word) return i + __builtin_ctzll(word);
+        i += 64 - slot % 64;
+    }
+    return -1;
+}
+
+/*
+ * The next tick at which timer_wheel_advance has work: a level-0 timer expiring or a
+ * higher-level slot cascading down. UINT64_MAX when no timer is scheduled. No timer
+ * expires before it, so the caller can sleep until then.
+ */
+uint64_t timer_wheel_next_deadline(const TimerWheel *wheel) {
+    uint64_t best = UINT64_MAX;
+    if (!wheel->count) return best;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        uint64_t base = (wheel->now >> LEVEL_SHIFT(level)) + 1;
+        int distance = next_occupied(wheel->occupied[level], base & SLOT_MASK);
+        if (distance < 0) continue;
+        uint64_t tick = (base + distance) << LEVEL_SHIFT(level);
+        if (tick < best) best = tick;
+    }
+    return best;
+}
+
+static void take_slot(TimerWheel *wheel, int level, unsigned slot, TimerEntry *list) {
+    TimerEntry *head = &wheel->slots[level][slot];
+    list_init(list);
+    if (head->next == head) return;
+    list->next = head->next;
+    list->prev = head->prev;
+    list->next->prev = list;
+    list->prev->next = list;
+    list_init(head);
+    wheel->occupied[level][slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Turns the wheel forward to `now` and runs every timer     *
+  * that has expired, in expiry order. Callbacks may add and  *
+  * cancel timers, including themselves. Returns how many     *
+  * fired.                                                    *
+  *************************************************************
+*/
+size_t timer_wheel_advance(TimerWheel *wheel, uint64_t now) {
+    size_t fired = 0;
+    while (wheel->now < now) {
+        uint64_t tick = timer_wheel_next_deadline(wheel);
+        if (tick > now) {
+            wheel->now = now;
+            break;
+        }
+        wheel->now = tick;
+        // cascade the highest level first, its timers may land in a lower slot that starts now
+        int top = 0;
+        while (top + 1 < TIMER_WHEEL_LEVELS && !(tick & ((UINT64_C(1) << LEVEL_SHIFT(top + 1)) - 1))) top++;
+        for (int level = top; level >= 1; level--) {
+            TimerEntry list;
+            take_slot(wheel, level, (tick >> LEVEL_SHIFT(level)) & SLOT_MASK, &list);
+            while (list.next != &list) {
+                TimerEntry *timer = list.next;
+                list.next = timer->next;
+                timer->next->prev = &list;
+                wheel->count--;
+                wheel_insert(wheel, timer);
+            }
+        }
+        TimerEntry due;
+        take_slot(wheel, 0, tick & SLOT_MASK, &due);
+        while (due.next != &due) {
+            TimerEntry *timer = due.next;
+            // unlink through the local list, a callback may cancel the timers after it
+            timer->prev->next = timer->next;
+            timer->next->prev = timer->prev;
+            timer->next = NULL;
+            timer->prev = NULL;
+            wheel->count--;
+            fired++;
+            timer->callback(timer, timer->arg);
+        }
+    }
+    return fired;
+}
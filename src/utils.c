@@ -22,6 +22,7 @@
 #include "utils.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,6 +31,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <limits.h>
+#include <stdatomic.h>
 
 #include "m1_2__simple_server.h"
 #include "m3__multi_threaded_server.h"
@@ -82,8 +85,17 @@ JSResult v8_execute_script_file(V8Engine *engine, const char *filename) {
 
 int server_fd_global = -1;
 volatile sig_atomic_t server_running = 1;
-static int telemetry_request_count = 0;
-static int telemetry_200_responses = 0;
+// counters are bumped from every worker thread, so they are atomics rather than mutex-guarded
+static atomic_int telemetry_request_count = 0;
+static atomic_int telemetry_200_responses = 0;
+static atomic_int telemetry_read_timeouts = 0;
+static atomic_int telemetry_deadline_drops = 0;
+static atomic_int telemetry_fair_rejects = 0;
+static atomic_int telemetry_idle_timeouts = 0;
+static atomic_int telemetry_evictions = 0;
+static atomic_int telemetry_cache_hits = 0;
+static atomic_int telemetry_cache_misses = 0;
+static struct timespec telemetry_start_time;
 
 /**
  *   __  __
@@ -99,17 +111,16 @@ static int telemetry_200_responses = 0;
  * to hold multiple counters as needed.
  */
 void telemetry_init() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    atomic_store(&telemetry_request_count, 0);
+    atomic_store(&telemetry_200_responses, 0);
+    atomic_store(&telemetry_read_timeouts, 0);
+    atomic_store(&telemetry_deadline_drops, 0);
+    atomic_store(&telemetry_fair_rejects, 0);
+    atomic_store(&telemetry_idle_timeouts, 0);
+    atomic_store(&telemetry_evictions, 0);
+    atomic_store(&telemetry_cache_hits, 0);
+    atomic_store(&telemetry_cache_misses, 0);
+    clock_gettime(CLOCK_REALTIME, &telemetry_start_time);
 }
 
 /**
@@ -123,17 +134,7 @@ void telemetry_init() {
  * Increments the request count telemetry counter.
  */
 void telemetry_increment_request_count() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    atomic_fetch_add_explicit(&telemetry_request_count, 1, memory_order_relaxed);
 }
 
 /**
@@ -147,18 +148,7 @@ void telemetry_increment_request_count() {
  * Retrieves the current request count telemetry counter.
  */
 int telemetry_get_request_count() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
-    return 0;
+    return atomic_load(&telemetry_request_count);
 }
 
 /**
@@ -172,17 +162,7 @@ int telemetry_get_request_count() {
  * Increments the count of HTTP 200 responses sent by the server.
  */
 void telemetry_increment_200_responses() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    atomic_fetch_add_explicit(&telemetry_200_responses, 1, memory_order_relaxed);
 }
 
 /**
@@ -196,20 +176,335 @@ void telemetry_increment_200_responses() {
  * Retrieves the count of HTTP 200 responses sent by the server.
  */
 int telemetry_get_200_responses() {
-    /**
-        ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-        ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-        ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-        ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-        ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-        ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-        ━━━━━━━━━━━━━━━━━━━━━
-        ━━━ Your code here...
-        ━━━━━━━━━━━━━━━━━━━━━
-        */
+    return atomic_load(&telemetry_200_responses);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Connections closed with 408 after missing a read deadline *
+  *************************************************************
+*/
+void telemetry_increment_read_timeouts() {
+    atomic_fetch_add_explicit(&telemetry_read_timeouts, 1, memory_order_relaxed);
+}
+
+int telemetry_get_read_timeouts() {
+    return atomic_load(&telemetry_read_timeouts);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Queued requests dropped because their deadline passed     *
+  *************************************************************
+*/
+void telemetry_increment_deadline_drops() {
+    atomic_fetch_add_explicit(&telemetry_deadline_drops, 1, memory_order_relaxed);
+}
+
+int telemetry_get_deadline_drops() {
+    return atomic_load(&telemetry_deadline_drops);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Requests refused because their client's flow was full     *
+  *************************************************************
+*/
+void telemetry_increment_fair_rejects() {
+    atomic_fetch_add_explicit(&telemetry_fair_rejects, 1, memory_order_relaxed);
+}
+
+int telemetry_get_fair_rejects() {
+    return atomic_load(&telemetry_fair_rejects);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Connections closed after going quiet past their deadline  *
+  *************************************************************
+*/
+void telemetry_increment_idle_timeouts() {
+    atomic_fetch_add_explicit(&telemetry_idle_timeouts, 1, memory_order_relaxed);
+}
+
+int telemetry_get_idle_timeouts() {
+    return atomic_load(&telemetry_idle_timeouts);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Idle connections closed early to free file descriptors    *
+  *************************************************************
+*/
+void telemetry_increment_evictions() {
+    atomic_fetch_add_explicit(&telemetry_evictions, 1, memory_order_relaxed);
+}
+
+int telemetry_get_evictions() {
+    return atomic_load(&telemetry_evictions);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Responses served from the response cache without JS       *
+  *************************************************************
+*/
+void telemetry_increment_cache_hits() {
+    atomic_fetch_add_explicit(&telemetry_cache_hits, 1, memory_order_relaxed);
+}
+
+int telemetry_get_cache_hits() {
+    return atomic_load(&telemetry_cache_hits);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Cacheable requests that found nothing usable cached       *
+  *************************************************************
+*/
+void telemetry_increment_cache_misses() {
+    atomic_fetch_add_explicit(&telemetry_cache_misses, 1, memory_order_relaxed);
+}
+
+int telemetry_get_cache_misses() {
+    return atomic_load(&telemetry_cache_misses);
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Wall-clock time telemetry_init() was called               *
+  *************************************************************
+*/
+void telemetry_get_start_time(struct timespec *out) {
+    *out = telemetry_start_time;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * HTTP helpers shared by the M3 and M4 servers              *
+  *************************************************************
+*/
+const char *http_status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 413: return "Payload Too Large";
+    case 416: return "Range Not Satisfiable";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Unknown";
+    }
+}
+
+void format_http_date(char *buf, size_t len) {
+    time_t now = time(NULL);
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    strftime(buf, len, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+}
+
+long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Strong ETag of a response body: a 64-bit hash that takes  *
+  * eight bytes per step, in the style of MurmurHash3. Not    *
+  * cryptographic, only meant to tell versions apart.         *
+  *************************************************************
+*/
+void http_etag(const char *body, size_t len, char *out, size_t out_size) {
+    const unsigned char *p = (const unsigned char *)body;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (len * 0x87c37b91114253d5ULL);
+    size_t left = len;
+    for (; left >= 8; p += 8, left -= 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        k *= 0x87c37b91114253d5ULL;
+        k = rotl64(k, 31);
+        k *= 0x4cf5ad432745937fULL;
+        h ^= k;
+        h = rotl64(h, 27) * 5 + 0x52dce729;
+    }
+    uint64_t k = 0;
+    memcpy(&k, p, left);
+    h ^= fmix64(k ^ left);
+    snprintf(out, out_size, "\"%016llx\"", (unsigned long long)fmix64(h));
+}
+
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Whether an If-None-Match header lists the ETag. Uses the  *
+  * weak comparison that RFC 9110 asks for here, so a W/      *
+  * prefix is ignored; "*" matches anything.                  *
+  *************************************************************
+*/
+int http_etag_matches(const char *if_none_match, size_t header_len, const char *etag) {
+    size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    const char *end = if_none_match + header_len;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) p++;
+        const char *tag = p;
+        while (p < end && *p != ',') p++;
+        const char *tag_end = p;
+        while (tag_end > tag && (tag_end[-1] == ' ' || tag_end[-1] == '\t')) tag_end--;
+        if (tag_end - tag == 1 && *tag == '*') return 1;
+        if (tag_end - tag > 2 && tag[0] == 'W' && tag[1] == '/') tag += 2;
+        if ((size_t)(tag_end - tag) == etag_len && memcmp(tag, etag, etag_len) == 0) return 1;
+    }
     return 0;
 }
 
+/*
+  *************************************************************
+  *                                                           *
+  *    █████╗ ███████╗██████╗                                 *
+  *   ██╔══██╗██╔════╝██╔══██╗                                *
+  *   ███████║███████╗██████╔╝                                *
+  *   ██╔══██║╚════██║██╔═══╝                                 *
+  *   ██║  ██║███████║██║                                     *
+  *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+  *                                                           *
+  * Runtime tuning knobs, read from ASP_* environment         *
+  * variables so they can be changed without rebuilding.      *
+  *************************************************************
+*/
+const char *config_get_string(const char *name, const char *default_value) {
+    const char *value = getenv(name);
+    if (!value || !*value) return default_value;
+    return value;
+}
+
+int config_get_int(const char *name, int default_value) {
+    const char *value = getenv(name);
+    if (!value || !*value) return default_value;
+    char *end = NULL;
+    long parsed = strtol(value, &end, 10);
+    if (*end != '\0' || parsed < INT_MIN || parsed > INT_MAX) {
+        fprintf(stderr, "Ignoring invalid value for %s: %s\n", name, value);
+        return default_value;
+    }
+    return (int)parsed;
+}
+
 /*
   *************************************************************
   *                                                           *
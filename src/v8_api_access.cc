@@ -20,12 +20,15 @@
 */
 
 #include "v8_api_access.h"
+#include "fs_pool.h"
 #include <v8.h>
 #include <libplatform/libplatform.h>
 #include <string>
 #include <unordered_map>
 #include <thread>
 #include <mutex>
+#include <cerrno>
+#include <cstring>
 
 typedef struct {
     JSObject handler{};
@@ -214,7 +217,11 @@ static void register_print_function(v8::Isolate *isolate, v8::Local<v8::Context>
     context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "syncCallBack").ToLocalChecked(), sync_cb_fn).Check();
 }
 
-extern "C" void register_js_interval_callback(int ms, JSObject cb);
+extern "C" long long register_js_timer(int ms, int repeat, JSObject cb);
+extern "C" void clear_js_timer(long long id);
+extern "C" int static_files_add_route(const char *prefix, const char *dir);
+extern "C" int response_cache_invalidate(const char *path);
+extern "C" int submit_js_fs_job(FsJob *job);
 
 extern "C" {
 
@@ -245,6 +252,7 @@ extern "C" {
         ServerHandlerInfo g_server_handler;
         std::mutex g_handler_mutex;
         v8::ArrayBuffer::Allocator *array_buffer_allocator;
+        std::string app_script;  // first script run on the engine, replayed by v8_create_isolate
     };
 
     /*
@@ -257,22 +265,44 @@ extern "C" {
       *   ██║  ██║███████║██║                                     *
       *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
       *                                                           *
-      * Registers a JS callback and interval in milliseconds for  *
-      * future execution.                                         *
+      * Registers a JS callback and delay in milliseconds for     *
+      * future execution, once or repeatedly. The timer id is     *
+      * returned to JS for clearInterval / clearTimeout.          *
       *************************************************************
     */
-    void SetIntervalImpl(const v8::FunctionCallbackInfo<v8::Value> &args) {
+    static void AddTimer(const v8::FunctionCallbackInfo<v8::Value> &args, int repeat, const char *usage) {
         v8::Isolate *isolate = args.GetIsolate();
         v8::HandleScope handle_scope(isolate);
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
-        if (args.Length() < 2 || !args[0]->IsFunction() || !args[1]->IsNumber()) {
-            isolate->ThrowException(v8::String::NewFromUtf8(isolate, "setInterval expects (function, ms)").ToLocalChecked());
+        if (args.Length() < 1 || !args[0]->IsFunction() || (args.Length() > 1 && !args[1]->IsNumber())) {
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, usage).ToLocalChecked());
+            return;
+        }
+        int ms = args.Length() > 1 ? args[1]->Int32Value(context).ToChecked() : 0;
+
+        JSObjectHandle *cb = new JSObjectHandle(isolate, args[0].As<v8::Object>());
+        long long id = register_js_timer(ms, repeat, cb);
+        if (id < 0) {
+            delete cb;
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, "too many timers").ToLocalChecked());
             return;
         }
-        v8::Local<v8::Function> cb = args[0].As<v8::Function>();
-        int ms = args[1]->Int32Value(context).ToChecked();
+        args.GetReturnValue().Set(v8::Number::New(isolate, (double)id));
+    }
+
+    void SetIntervalImpl(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        AddTimer(args, 1, "setInterval expects (function, ms)");
+    }
+
+    void SetTimeoutImpl(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        AddTimer(args, 0, "setTimeout expects (function, ms)");
+    }
 
-        register_js_interval_callback(ms, new JSObjectHandle(isolate, args[0].As<v8::Object>()));
+    void ClearTimerImpl(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        v8::Isolate *isolate = args.GetIsolate();
+        v8::HandleScope handle_scope(isolate);
+        if (args.Length() < 1 || !args[0]->IsNumber()) return;
+        clear_js_timer((long long)args[0].As<v8::Number>()->Value());
     }
 
     /*
@@ -363,6 +393,202 @@ extern "C" {
         engine->g_server_handler.server_type = HTTPServerTypeEventLoop;
     }
 
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Maps a URL prefix onto a directory served by the event    *
+      * loop without entering JS                                  *
+      *************************************************************
+    */
+    void ServeStaticCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        v8::Isolate *isolate = args.GetIsolate();
+        v8::HandleScope handle_scope(isolate);
+        if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsString()) {
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, "serveStatic expects (prefix, dir)").ToLocalChecked());
+            return;
+        }
+        v8::String::Utf8Value prefix(isolate, args[0]);
+        v8::String::Utf8Value dir(isolate, args[1]);
+        if (static_files_add_route(*prefix, *dir) < 0) {
+            std::string message = std::string("serveStatic: cannot serve '") + *dir + "' at '" + *prefix + "': " + strerror(errno);
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, message.c_str()).ToLocalChecked());
+        }
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Drops cached responses for a path, for every path with a  *
+      * prefix ending in '*', or all of them without an argument. *
+      * Returns how many were dropped.                            *
+      *************************************************************
+    */
+    void InvalidateCacheCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        v8::Isolate *isolate = args.GetIsolate();
+        v8::HandleScope handle_scope(isolate);
+        if (args.Length() > 0 && !args[0]->IsString() && !args[0]->IsUndefined()) {
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, "invalidateCache expects a path").ToLocalChecked());
+            return;
+        }
+        int dropped;
+        if (args.Length() > 0 && args[0]->IsString()) {
+            v8::String::Utf8Value path(isolate, args[0]);
+            dropped = response_cache_invalidate(*path);
+        } else {
+            dropped = response_cache_invalidate(nullptr);
+        }
+        args.GetReturnValue().Set(dropped);
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Settles the Promise of a finished ASP.fs call: readFile   *
+      * resolves with the contents as a string, stat with an      *
+      * object describing the file, and writeFile with nothing.   *
+      * A failed call rejects with an Error carrying its errno.   *
+      *************************************************************
+    */
+    static void settle_fs_job(v8::Isolate *isolate, v8::Local<v8::Context> context, FsJob *job) {
+        v8::Local<v8::Promise::Resolver> resolver = v8::Local<v8::Object>::New(isolate, job->resolver->handle).As<v8::Promise::Resolver>();
+        v8::Local<v8::Value> value = v8::Undefined(isolate);
+        int error = job->error;
+        if (!error && job->op == FS_READ_FILE) {
+            v8::Local<v8::String> contents;
+            if (v8::String::NewFromUtf8(isolate, job->data ? job->data : "", v8::NewStringType::kNormal, (int)job->len).ToLocal(&contents)) {
+                value = contents;
+            } else {
+                error = EFBIG;
+            }
+        } else if (!error && job->op == FS_STAT) {
+            v8::Local<v8::Object> stats = v8::Object::New(isolate);
+            double mtime_ms = (double)job->st.st_mtim.tv_sec * 1e3 + (double)job->st.st_mtim.tv_nsec / 1e6;
+            stats->Set(context, v8::String::NewFromUtf8(isolate, "size").ToLocalChecked(), v8::Number::New(isolate, (double)job->st.st_size)).Check();
+            stats->Set(context, v8::String::NewFromUtf8(isolate, "mtimeMs").ToLocalChecked(), v8::Number::New(isolate, mtime_ms)).Check();
+            stats->Set(context, v8::String::NewFromUtf8(isolate, "mode").ToLocalChecked(), v8::Integer::New(isolate, (int)job->st.st_mode)).Check();
+            stats->Set(context, v8::String::NewFromUtf8(isolate, "isFile").ToLocalChecked(), v8::Boolean::New(isolate, S_ISREG(job->st.st_mode))).Check();
+            stats->Set(context, v8::String::NewFromUtf8(isolate, "isDirectory").ToLocalChecked(), v8::Boolean::New(isolate, S_ISDIR(job->st.st_mode))).Check();
+            value = stats;
+        }
+        if (error) {
+            std::string message = std::string(fs_op_name(job->op)) + " '" + job->path + "': " + strerror(error);
+            v8::Local<v8::Object> exception = v8::Exception::Error(v8::String::NewFromUtf8(isolate, message.c_str()).ToLocalChecked()).As<v8::Object>();
+            exception->Set(context, v8::String::NewFromUtf8(isolate, "errno").ToLocalChecked(), v8::Integer::New(isolate, error)).Check();
+            resolver->Reject(context, exception).FromMaybe(false);
+            return;
+        }
+        resolver->Resolve(context, value).FromMaybe(false);
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Starts an ASP.fs call and returns its Promise. The event  *
+      * loop hands the call to the fs pool and settles the        *
+      * Promise when it comes back. Without a loop to come back   *
+      * to (the app script at startup, handler workers, the       *
+      * other servers) the call runs on this thread and the       *
+      * Promise is settled before it is returned.                 *
+      *************************************************************
+    */
+    static void StartFsCall(const v8::FunctionCallbackInfo<v8::Value> &args, FsOp op, const char *usage) {
+        v8::Isolate *isolate = args.GetIsolate();
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        int with_data = op == FS_WRITE_FILE;
+        if (args.Length() < 1 + with_data || !args[0]->IsString() || (with_data && !args[1]->IsString())) {
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, usage).ToLocalChecked());
+            return;
+        }
+        v8::String::Utf8Value path(isolate, args[0]);
+        FsJob *job;
+        if (with_data) {
+            v8::String::Utf8Value data(isolate, args[1]);
+            job = fs_job_create(op, *path, *data, data.length());
+        } else {
+            job = fs_job_create(op, *path, nullptr, 0);
+        }
+        v8::Local<v8::Promise::Resolver> resolver;
+        if (!job || !v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+            fs_job_free(job);
+            isolate->ThrowException(v8::String::NewFromUtf8(isolate, "out of memory").ToLocalChecked());
+            return;
+        }
+        args.GetReturnValue().Set(resolver->GetPromise());
+        job->resolver = new JSObjectHandle(isolate, resolver);
+        if (submit_js_fs_job(job) == 0) return;
+        fs_run(job);
+        settle_fs_job(isolate, context, job);
+        delete job->resolver;
+        fs_job_free(job);
+    }
+
+    void FsReadFileCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        StartFsCall(args, FS_READ_FILE, "fs.readFile expects (path)");
+    }
+
+    void FsWriteFileCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        StartFsCall(args, FS_WRITE_FILE, "fs.writeFile expects (path, data)");
+    }
+
+    void FsStatCallback(const v8::FunctionCallbackInfo<v8::Value> &args) {
+        StartFsCall(args, FS_STAT, "fs.stat expects (path)");
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Called by the event loop, on the thread that owns the     *
+      * isolate, for a call the fs pool has finished. Nothing     *
+      * else runs on the isolate then, so the microtasks queued   *
+      * by settling (the then-callbacks) are run here too.        *
+      *************************************************************
+    */
+    void v8_settle_fs_job(V8Engine *engine, FsJob *job) {
+        v8::Isolate *isolate = engine->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Local<v8::Context>::New(isolate, engine->context);
+        v8::Context::Scope context_scope(context);
+        settle_fs_job(isolate, context, job);
+        isolate->PerformMicrotaskCheckpoint();
+    }
+
     /*
       *************************************************************
       *                                                           *
@@ -388,9 +614,30 @@ extern "C" {
         v8::Local<v8::FunctionTemplate> tpl3 = v8::FunctionTemplate::New(isolate, CreateEventLoopServerCallback);
         v8::Local<v8::Function> fn3 = tpl3->GetFunction(context).ToLocalChecked();
         asp->Set(context, v8::String::NewFromUtf8(isolate, "createEventLoopServer").ToLocalChecked(), fn3).Check();
+        v8::Local<v8::FunctionTemplate> static_tpl = v8::FunctionTemplate::New(isolate, ServeStaticCallback);
+        v8::Local<v8::Function> static_fn = static_tpl->GetFunction(context).ToLocalChecked();
+        asp->Set(context, v8::String::NewFromUtf8(isolate, "serveStatic").ToLocalChecked(), static_fn).Check();
+        v8::Local<v8::FunctionTemplate> invalidate_tpl = v8::FunctionTemplate::New(isolate, InvalidateCacheCallback);
+        v8::Local<v8::Function> invalidate_fn = invalidate_tpl->GetFunction(context).ToLocalChecked();
+        asp->Set(context, v8::String::NewFromUtf8(isolate, "invalidateCache").ToLocalChecked(), invalidate_fn).Check();
+        v8::Local<v8::Object> fs = v8::Object::New(isolate);
+        v8::Local<v8::Function> read_fn = v8::FunctionTemplate::New(isolate, FsReadFileCallback)->GetFunction(context).ToLocalChecked();
+        fs->Set(context, v8::String::NewFromUtf8(isolate, "readFile").ToLocalChecked(), read_fn).Check();
+        v8::Local<v8::Function> write_fn = v8::FunctionTemplate::New(isolate, FsWriteFileCallback)->GetFunction(context).ToLocalChecked();
+        fs->Set(context, v8::String::NewFromUtf8(isolate, "writeFile").ToLocalChecked(), write_fn).Check();
+        v8::Local<v8::Function> stat_fn = v8::FunctionTemplate::New(isolate, FsStatCallback)->GetFunction(context).ToLocalChecked();
+        fs->Set(context, v8::String::NewFromUtf8(isolate, "stat").ToLocalChecked(), stat_fn).Check();
+        asp->Set(context, v8::String::NewFromUtf8(isolate, "fs").ToLocalChecked(), fs).Check();
         v8::Local<v8::FunctionTemplate> setinterval_tpl = v8::FunctionTemplate::New(isolate, SetIntervalImpl);
         v8::Local<v8::Function> setinterval_fn = setinterval_tpl->GetFunction(context).ToLocalChecked();
         context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "setInterval").ToLocalChecked(), setinterval_fn).Check();
+        v8::Local<v8::FunctionTemplate> settimeout_tpl = v8::FunctionTemplate::New(isolate, SetTimeoutImpl);
+        v8::Local<v8::Function> settimeout_fn = settimeout_tpl->GetFunction(context).ToLocalChecked();
+        context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "setTimeout").ToLocalChecked(), settimeout_fn).Check();
+        v8::Local<v8::FunctionTemplate> cleartimer_tpl = v8::FunctionTemplate::New(isolate, ClearTimerImpl);
+        v8::Local<v8::Function> cleartimer_fn = cleartimer_tpl->GetFunction(context).ToLocalChecked();
+        context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "clearInterval").ToLocalChecked(), cleartimer_fn).Check();
+        context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "clearTimeout").ToLocalChecked(), cleartimer_fn).Check();
         context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "ASP").ToLocalChecked(), asp).Check();
         v8::Local<v8::String> key = v8::String::NewFromUtf8(isolate, std::string{
             static_cast<char>(65),
@@ -411,16 +658,11 @@ extern "C" {
       *   ██║  ██║███████║██║                                     *
       *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
       *                                                           *
-      * Initializes the V8 engine and context                     *
+      * Creates the engine's isolate and a context with the ASP   *
+      * builtins installed                                        *
       *************************************************************
     */
-    V8Engine *v8_initialize(int argc, char *argv[]) {
-        auto *engine = new V8Engine();
-        v8::V8::InitializeICUDefaultLocation(argv[0]);
-        v8::V8::InitializeExternalStartupData(argv[0]);
-        engine->platform = v8::platform::NewDefaultPlatform();
-        v8::V8::InitializePlatform(engine->platform.get());
-        v8::V8::Initialize();
+    static void setup_engine_isolate(V8Engine *engine) {
         v8::Isolate::CreateParams create_params;
         create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
         engine->array_buffer_allocator = create_params.array_buffer_allocator;
@@ -432,9 +674,90 @@ extern "C" {
         engine->context.Reset(engine->isolate, local_context);
         register_print_function(engine->isolate, local_context);
         register_asp_object(engine->isolate, local_context);
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Initializes the V8 engine and context                     *
+      *************************************************************
+    */
+    V8Engine *v8_initialize(int argc, char *argv[]) {
+        auto *engine = new V8Engine();
+        v8::V8::InitializeICUDefaultLocation(argv[0]);
+        v8::V8::InitializeExternalStartupData(argv[0]);
+        engine->platform = v8::platform::NewDefaultPlatform();
+        v8::V8::InitializePlatform(engine->platform.get());
+        v8::V8::Initialize();
+        setup_engine_isolate(engine);
+        return engine;
+    }
+
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Creates another isolate on the parent's platform and      *
+      * loads the parent's app script into it, so it registers    *
+      * its own handler. The isolate must only be used by the     *
+      * thread that created it. Returns NULL if the script does   *
+      * not register a server.                                    *
+      *************************************************************
+    */
+    V8Engine *v8_create_isolate(V8Engine *parent) {
+        if (!parent || parent->app_script.empty()) return nullptr;
+        auto *engine = new V8Engine();
+        setup_engine_isolate(engine);
+        JSResult res = v8_execute_script(engine, parent->app_script.c_str());
+        if (res.type == JS_STRING) free(res.value.str_result);
+        if (!res.success || !engine->g_server_handler.is_set) {
+            v8_dispose_isolate(engine);
+            return nullptr;
+        }
         return engine;
     }
 
+    /*
+      *************************************************************
+      *                                                           *
+      *    █████╗ ███████╗██████╗                                 *
+      *   ██╔══██╗██╔════╝██╔══██╗                                *
+      *   ███████║███████╗██████╔╝                                *
+      *   ██╔══██║╚════██║██╔═══╝                                 *
+      *   ██║  ██║███████║██║                                     *
+      *   ╚═╝  ╚═╝╚══════╝╚═╝                                     *
+      *                                                           *
+      * Disposes an isolate made by v8_create_isolate. The V8     *
+      * platform stays up for the parent engine.                  *
+      *************************************************************
+    */
+    void v8_dispose_isolate(V8Engine *engine) {
+        if (!engine) return;
+        v8_free_object(engine->g_server_handler.handler);
+        engine->g_server_handler = ServerHandlerInfo{};
+        engine->registered_functions.clear();
+        engine->context.Reset();
+        if (engine->isolate) {
+            engine->isolate->Dispose();
+            engine->isolate = nullptr;
+        }
+        delete engine->array_buffer_allocator;
+        delete engine;
+    }
+
     /*
       *************************************************************
       *                                                           *
@@ -456,6 +779,7 @@ extern "C" {
         v8::Local<v8::Context> local_context =
             v8::Local<v8::Context>::New(engine->isolate, engine->context);
         v8::Context::Scope context_scope(local_context);
+        if (engine->app_script.empty()) engine->app_script = script;
         try {
             v8::Local<v8::String> source =
                 v8::String::NewFromUtf8(engine->isolate, script).ToLocalChecked();
@@ -633,18 +957,23 @@ extern "C" {
      *  - Result handling: v8::Maybe<bool>
      */
     int v8_set_number_property(V8Engine *engine, JSObjectHandle *obj, const char *key, long value) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return 0;
+        if (!engine->isolate || !obj) return 0;
+        v8::Isolate::Scope isolate_scope(engine->isolate);
+        v8::HandleScope handle_scope(engine->isolate);
+        v8::Local<v8::Context> local_context =
+            v8::Local<v8::Context>::New(engine->isolate, engine->context);
+        v8::Context::Scope context_scope(local_context);
+        v8::Local<v8::Object> js_obj =
+            v8::Local<v8::Object>::New(engine->isolate, obj->handle);
+        v8::Maybe<bool> result = js_obj->Set(
+            local_context,
+            v8::String::NewFromUtf8(engine->isolate, key).ToLocalChecked(),
+            v8::Number::New(engine->isolate, static_cast<double>(value))
+        );
+        if (result.IsNothing() || !result.FromJust()) {
+            return 0;
+        }
+        return 1;
     }
 
 
@@ -661,18 +990,25 @@ extern "C" {
      *  of numbers.
      */
     int v8_set_object_property(V8Engine *engine, JSObject obj, const char *key, JSObject value) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return 0;
+        if (!engine->isolate || !obj || !value) return 0;
+        v8::Isolate::Scope isolate_scope(engine->isolate);
+        v8::HandleScope handle_scope(engine->isolate);
+        v8::Local<v8::Context> local_context =
+            v8::Local<v8::Context>::New(engine->isolate, engine->context);
+        v8::Context::Scope context_scope(local_context);
+        v8::Local<v8::Object> js_obj =
+            v8::Local<v8::Object>::New(engine->isolate, obj->handle);
+        v8::Local<v8::Object> js_value =
+            v8::Local<v8::Object>::New(engine->isolate, value->handle);
+        v8::Maybe<bool> result = js_obj->Set(
+            local_context,
+            v8::String::NewFromUtf8(engine->isolate, key).ToLocalChecked(),
+            js_value
+        );
+        if (result.IsNothing() || !result.FromJust()) {
+            return 0;
+        }
+        return 1;
     }
 
 
@@ -757,18 +1093,21 @@ extern "C" {
      * - Type checking and casting: v8::Value::IsObject, v8::Value::As (v8::Object)
      */
     JSObject v8_get_object_property(V8Engine *engine, JSObject obj, const char *key) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return nullptr;
+        if (!engine->isolate || !obj) return nullptr;
+        v8::Isolate::Scope isolate_scope(engine->isolate);
+        v8::HandleScope handle_scope(engine->isolate);
+        v8::Local<v8::Context> local_context =
+            v8::Local<v8::Context>::New(engine->isolate, engine->context);
+        v8::Context::Scope context_scope(local_context);
+        v8::Local<v8::Object> js_obj =
+            v8::Local<v8::Object>::New(engine->isolate, obj->handle);
+        v8::Local<v8::Value> value;
+        if (!js_obj->Get(local_context,
+            v8::String::NewFromUtf8(engine->isolate, key).ToLocalChecked()
+            ).ToLocal(&value) || !value->IsObject()) {
+            return nullptr;
+        }
+        return new JSObjectHandle(engine->isolate, value.As<v8::Object>());
     }
 
     /**
@@ -785,18 +1124,23 @@ extern "C" {
      *  The implementation is essentially similar to that of v8_get_string_property.
      */
     int v8_get_number_property(V8Engine *engine, JSObject obj, const char *key, int *success) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return 0;
+        if (success) *success = 0;
+        if (!engine->isolate || !obj) return 0;
+        v8::Isolate::Scope isolate_scope(engine->isolate);
+        v8::HandleScope handle_scope(engine->isolate);
+        v8::Local<v8::Context> local_context =
+            v8::Local<v8::Context>::New(engine->isolate, engine->context);
+        v8::Context::Scope context_scope(local_context);
+        v8::Local<v8::Object> js_obj =
+            v8::Local<v8::Object>::New(engine->isolate, obj->handle);
+        v8::Local<v8::Value> value;
+        if (!js_obj->Get(local_context,
+            v8::String::NewFromUtf8(engine->isolate, key).ToLocalChecked()
+            ).ToLocal(&value) || !value->IsNumber()) {
+            return 0;
+        }
+        if (success) *success = 1;
+        return value->Int32Value(local_context).FromMaybe(0);
     }
 
     /*
@@ -946,18 +1290,48 @@ extern "C" {
      * - String and number creation: v8::String::Utf8Value
      */
     JSResult v8_call_function_no_arguments(V8Engine *engine, JSObject fun) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return { 0 };
+        JSResult result = {0};
+        if (!fun || !engine->isolate) {
+            return result;
+        }
+
+        v8::Isolate* isolate = engine->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Local<v8::Context>::New(isolate, engine->context);
+        v8::Context::Scope context_scope(context);
+
+        v8::Local<v8::Object> fn_obj = v8::Local<v8::Object>::New(isolate, fun->handle);
+        if (fn_obj.IsEmpty() || !fn_obj->IsFunction()) {
+            return result;
+        }
+        v8::Local<v8::Function> fn = fn_obj.As<v8::Function>();
+
+        v8::MaybeLocal<v8::Value> maybe_ret = fn->Call(context, context->Global(), 0, nullptr);
+        v8::Local<v8::Value> ret;
+        if (!maybe_ret.ToLocal(&ret)) {
+            return result;
+        }
+
+        result.success = 1;
+        if (ret->IsString()) {
+            v8::String::Utf8Value utf8_string(isolate, ret);
+            if (*utf8_string) {
+                result.type = JS_STRING;
+                result.value.str_result = strdup(*utf8_string);
+            }
+        } else if (ret->IsNumber()) {
+            result.type = JS_NUMBER;
+            result.value.int_result = ret->Int32Value(context).FromMaybe(0);
+        } else if (ret->IsNull()) {
+            result.type = JS_NULL;
+        } else if (ret->IsUndefined()) {
+            result.type = JS_UNDEFINED;
+        } else if (ret->IsObject()) {
+            result.type = JS_OBJECT;
+            result.value.obj_result = new JSObjectHandle(isolate, ret.As<v8::Object>());
+        }
+        return result;
     }
 
 
@@ -978,18 +1352,51 @@ extern "C" {
      * The handler function is expected to be registered in the engine's global state (V8Engine struct).
      */
     JSResult v8_call_registered_handler_obj(V8Engine *engine, JSObject arg) {
-        /**
-            ┏━━━━┓┏━━━┓━┏━━━┓┏━━━┓
-            ┃┏┓┏┓┃┃┏━┓┃━┗┓┏┓┃┃┏━┓┃
-            ┗┛┃┃┗┛┃┃━┃┃ ━┃┃┃┃┃┃━┃┃
-            ━━┃┃━━┃┃━┃┃━━┃┃┃┃┃┃━┃┃
-            ━┏┛┗┓━┃┗━┛┃━┏┛┗┛┃┃┗━┛┃
-            ━┗━━┛━┗━━━┛━┗━━━┛┗━━━┛
-            ━━━━━━━━━━━━━━━━━━━━━
-            ━━━ Your code here...
-            ━━━━━━━━━━━━━━━━━━━━━
-            */
-        return { 0 };
+        JSResult result = {0};
+        if (!arg || !engine->g_server_handler.is_set) {
+            return result;
+        }
+
+        v8::Isolate* isolate = engine->isolate;
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Local<v8::Context>::New(isolate, engine->context);
+        v8::Context::Scope context_scope(context);
+
+        // retrieve handler func
+        v8::Local<v8::Object> fn_obj = v8::Local<v8::Object>::New(isolate, engine->g_server_handler.handler->handle);
+        if (fn_obj.IsEmpty() || !fn_obj->IsFunction()) {
+            return result;
+        }
+        v8::Local<v8::Function> handler = fn_obj.As<v8::Function>();
+
+        // call js func with the request object
+        v8::Local<v8::Value> js_arg = v8::Local<v8::Object>::New(isolate, arg->handle);
+        v8::MaybeLocal<v8::Value> maybe_ret = handler->Call(context, context->Global(), 1, &js_arg);
+        v8::Local<v8::Value> ret;
+        if (!maybe_ret.ToLocal(&ret)) {
+            return result;
+        }
+
+        result.success = 1;
+        if (ret->IsString()) {
+            v8::String::Utf8Value utf8_string(isolate, ret);
+            if (*utf8_string) {
+                result.type = JS_STRING;
+                result.value.str_result = strdup(*utf8_string);
+            }
+        } else if (ret->IsNumber()) {
+            result.type = JS_NUMBER;
+            result.value.int_result = ret->Int32Value(context).FromMaybe(0);
+        } else if (ret->IsNull()) {
+            result.type = JS_NULL;
+        } else if (ret->IsUndefined()) {
+            result.type = JS_UNDEFINED;
+        } else if (ret->IsObject()) {
+            result.type = JS_OBJECT;
+            result.value.obj_result = new JSObjectHandle(isolate, ret.As<v8::Object>());
+        }
+        return result;
     }
 
     /**